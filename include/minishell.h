@@ -7,6 +7,7 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/resource.h>
 #include <readline/readline.h>
 #include <readline/history.h>
 #include <string.h>
@@ -20,11 +21,18 @@
 
 typedef struct s_minishell t_minishell;
 
+#include "../src/arena/arena.h"
+#include "../src/io/io.h"
+#include "../src/env/env.h"
 #include "../src/lexer/lexer.h"
 #include "../src/signal/signal.h"
 #include "../src/parse/parse.h"
 #include "../src/exec/exec.h"
+#include "../src/event/event.h"
+#include "../src/trace/trace.h"
+#include "../src/stats/stats.h"
 #include "../src/expansion/expander.h"
+#include "../src/loop/loop.h"
 
 
 
@@ -33,16 +41,31 @@ extern volatile sig_atomic_t g_signal;
 typedef struct s_minishell
 {
 	// lexer
-	t_lexer *lexer;
+	t_tokens tokens; // 当前行的 token 序列（数组跨行复用）
 	// char                        *args;
 
 	char *raw_line; // 原始输入行
+	t_reader *in;	// 当前输入：交互时为 rd_stdin()，脚本 / -c 时为指向文本的内存读取器
+	struct s_batch *batch; // 批处理模式（标准输入不是终端）的预读队列，其他模式为 NULL
+
+	t_arena *arena; // 本行 lexer/expander/parser/AST 共用的内存池，每行结束时整体 reset
+	int debug;		// 设置了 MINISHELL_DEBUG 时为 1，打印每行的调试统计
+	int interactive; // 交互模式（readline 主循环）：结束的后台作业在提示符前报告
+	int lastpipe;	 // 启动时设置了 MINISHELL_LASTPIPE：管道最后的内建阶段在 shell 里执行
+	t_strbuf expand_buf; // expander 的输出缓冲，跨 token / 跨行复用
+	int exp_skipped;	 // 本行原样保留、未进入展开的 WORD 数（调试统计）
+	int exp_expanded;	 // 本行实际展开/去引号的 WORD 数（调试统计）
 
 	int n_pipes; // 管道 “|” 的个数（cmd 数 - 1）
 
 	int last_exit_status; // 上一条命令退出状态（用于 $? 扩展）
+	int disposable;		  // 本进程是 fork 出来的一次性子进程：最后一条外部命令直接 exec，不再 fork
+	int async;			  // 正在启动后台作业（或本进程就是后台作业）：子进程忽略 SIGINT / SIGQUIT
+	t_jobs jobs;		  // 后台作业表（cmd &）
+	struct s_timing *timing; // 正在执行 time 计时的管道时指向它的计时记录，否则为 NULL
 
-	char **envp;
+	t_env *env;	// 环境变量表（哈希表，$VAR 展开与内建命令共用）
+	t_cmd_cache cmds; // 命令名 → 绝对路径的缓存（hash 内建命令管理）
 	char **paths;
 
 	// loop
@@ -0,0 +1,208 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   arena.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 09:02:11 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 09:02:11 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+/**
+ * chunk_new
+ * ----------------
+ * 目的：
+ *   分配一个新块，容量至少为 ARENA_CHUNK_SIZE，大分配则按需放大。
+ */
+static t_arena_chunk *chunk_new(size_t size)
+{
+	t_arena_chunk *chunk;
+	size_t cap;
+
+	cap = ARENA_CHUNK_SIZE;
+	if (size > cap)
+		cap = size;
+	chunk = malloc(sizeof(t_arena_chunk) + cap);
+	if (!chunk)
+		return (NULL);
+	chunk->next = NULL;
+	chunk->cap = cap;
+	chunk->used = 0;
+	return (chunk);
+}
+
+/**
+ * arena_next_chunk
+ * ----------------
+ * 目的：
+ *   当前块放不下 size 字节时，切换到下一块。
+ *
+ * 行为说明：
+ *   1. 优先复用上一轮留下的后继块（reset 之后它们仍挂在链表上）
+ *   2. 后继块不存在或太小，则新建一块插到 cur 之后
+ */
+static t_arena_chunk *arena_next_chunk(t_arena *arena, size_t size)
+{
+	t_arena_chunk *next;
+	t_arena_chunk *fresh;
+
+	if (arena->cur)
+		next = arena->cur->next;
+	else
+		next = arena->head;
+	if (next && next->cap >= size)
+	{
+		next->used = 0;
+		arena->cur = next;
+		return (next);
+	}
+	fresh = chunk_new(size);
+	if (!fresh)
+		return (NULL);
+	fresh->next = next;
+	if (arena->cur)
+		arena->cur->next = fresh;
+	else
+		arena->head = fresh;
+	arena->cur = fresh;
+	arena->n_chunks++;
+	arena->capacity += fresh->cap;
+	return (fresh);
+}
+
+t_arena *arena_new(void)
+{
+	return (ft_calloc(1, sizeof(t_arena)));
+}
+
+/**
+ * arena_alloc
+ * ----------------
+ * 目的：
+ *   从 arena 中分配 size 字节（按 ARENA_ALIGN 对齐），内容未初始化。
+ *
+ * 返回值：
+ *   - 成功：指向新内存的指针（无需也不能单独 free）
+ *   - 失败：NULL
+ */
+void *arena_alloc(t_arena *arena, size_t size)
+{
+	t_arena_chunk *chunk;
+	void *ptr;
+
+	if (!arena)
+		return (NULL);
+	size = (size + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1);
+	if (size == 0)
+		size = ARENA_ALIGN;
+	chunk = arena->cur;
+	if (!chunk || chunk->cap - chunk->used < size)
+		chunk = arena_next_chunk(arena, size);
+	if (!chunk)
+		return (NULL);
+	ptr = chunk->data + chunk->used;
+	chunk->used += size;
+	arena->n_allocs++;
+	arena->n_bytes += size;
+	return (ptr);
+}
+
+void *arena_calloc(t_arena *arena, size_t nmemb, size_t size)
+{
+	void *ptr;
+
+	if (size && nmemb > SIZE_MAX / size)
+		return (NULL);
+	ptr = arena_alloc(arena, nmemb * size);
+	if (ptr)
+		ft_bzero(ptr, nmemb * size);
+	return (ptr);
+}
+
+char *arena_strndup(t_arena *arena, const char *s, size_t n)
+{
+	char *dup;
+
+	if (!s)
+		return (NULL);
+	dup = arena_alloc(arena, n + 1);
+	if (!dup)
+		return (NULL);
+	ft_memcpy(dup, s, n);
+	dup[n] = '\0';
+	return (dup);
+}
+
+char *arena_strdup(t_arena *arena, const char *s)
+{
+	if (!s)
+		return (NULL);
+	return (arena_strndup(arena, s, ft_strlen(s)));
+}
+
+/**
+ * arena_reset
+ * ----------------
+ * 目的：
+ *   一条命令行处理完毕后整体回收 arena 中的所有分配。
+ *
+ * 行为说明：
+ *   1. 常规情况 O(1)：只把 cur 指回第一块并清零计数，块本身留给下一行复用
+ *   2. 若持有的总容量超过 ARENA_KEEP_MAX（出现过超长命令），
+ *      只保留第一块，其余归还给系统
+ */
+void arena_reset(t_arena *arena)
+{
+	t_arena_chunk *chunk;
+	t_arena_chunk *next;
+
+	if (!arena || !arena->head)
+		return ;
+	if (arena->capacity > ARENA_KEEP_MAX)
+	{
+		chunk = arena->head->next;
+		while (chunk)
+		{
+			next = chunk->next;
+			free(chunk);
+			chunk = next;
+		}
+		arena->head->next = NULL;
+		arena->n_chunks = 1;
+		arena->capacity = arena->head->cap;
+	}
+	arena->head->used = 0;
+	arena->cur = arena->head;
+	arena->n_allocs = 0;
+	arena->n_bytes = 0;
+}
+
+void arena_destroy(t_arena *arena)
+{
+	t_arena_chunk *chunk;
+	t_arena_chunk *next;
+
+	if (!arena)
+		return ;
+	chunk = arena->head;
+	while (chunk)
+	{
+		next = chunk->next;
+		free(chunk);
+		chunk = next;
+	}
+	free(arena);
+}
+
+/* 调试输出：打印本行的分配次数与字节数（MINISHELL_DEBUG 打开时由 main 调用） */
+void arena_report(t_arena *arena)
+{
+	if (!arena)
+		return ;
+	fprintf(stderr, "[arena] allocs=%zu bytes=%zu chunks=%zu\n",
+		arena->n_allocs, arena->n_bytes, arena->n_chunks);
+}
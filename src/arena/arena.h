@@ -0,0 +1,69 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   arena.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 09:02:11 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 09:02:11 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/* 每块的默认容量；超过此大小的单次分配会获得一个专属块 */
+#define ARENA_CHUNK_SIZE 8192
+/* reset 时保留的最大内存；超出部分归还给系统，防止一条超长命令永久占用内存 */
+#define ARENA_KEEP_MAX 1048576
+#define ARENA_ALIGN 16
+
+/**
+ * s_arena_chunk
+ * ----------------
+ * 一块连续内存。块之间用单向链表串起来，reset 后按顺序复用。
+ */
+typedef struct s_arena_chunk
+{
+	struct s_arena_chunk *next;
+	size_t cap;
+	size_t used;
+	_Alignas(ARENA_ALIGN) char data[];
+} t_arena_chunk;
+
+/**
+ * s_arena
+ * ----------------
+ * 每条命令行一个的“碰撞指针”分配器：
+ * lexer → expander → parser → AST 四个阶段的所有小块内存都从这里分配，
+ * 一行结束时 arena_reset 一次性整体回收（不逐个 free）。
+ *
+ * - head / cur : 块链表头 / 当前正在分配的块
+ * - n_allocs   : 本行的分配次数（调试输出用）
+ * - n_bytes    : 本行分配的字节数
+ * - n_chunks   : 当前持有的块数
+ * - capacity   : 当前持有的总容量（决定 reset 时是否需要归还内存）
+ */
+typedef struct s_arena
+{
+	t_arena_chunk *head;
+	t_arena_chunk *cur;
+	size_t n_allocs;
+	size_t n_bytes;
+	size_t n_chunks;
+	size_t capacity;
+} t_arena;
+
+t_arena *arena_new(void);
+void *arena_alloc(t_arena *arena, size_t size);
+void *arena_calloc(t_arena *arena, size_t nmemb, size_t size);
+char *arena_strdup(t_arena *arena, const char *s);
+char *arena_strndup(t_arena *arena, const char *s, size_t n);
+void arena_reset(t_arena *arena);
+void arena_destroy(t_arena *arena);
+void arena_report(t_arena *arena);
+
+#endif
@@ -0,0 +1,84 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   env.h                                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:05:31 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 14:05:31 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef ENV_H
+#define ENV_H
+
+#include <stddef.h>
+
+/* 哈希槽数组的初始大小（必须是 2 的幂） */
+#define ENV_INIT_SLOTS 64
+/* 槽位空闲 / 已删除（墓碑）标记 */
+#define ENV_SLOT_EMPTY -1
+#define ENV_SLOT_DEAD -2
+
+/**
+ * s_env_var
+ * ----------------
+ * 一个环境变量。
+ * - key   : 变量名
+ * - value : 值；NULL 表示只 export 了名字、没有赋值（env 不打印它）
+ * - hash  : key 的哈希值（扩容重排时不必重新计算）
+ * - alive : 0 表示已被 unset，只在 vars 中留一个空位，等待压缩
+ */
+typedef struct s_env_var
+{
+	char *key;
+	char *value;
+	unsigned int hash;
+	int alive;
+} t_env_var;
+
+/**
+ * s_env
+ * ----------------
+ * shell 的环境变量表：开放寻址哈希表 + 按插入顺序排列的稠密数组。
+ *
+ * - vars / n_vars / cap_vars : 变量本体，按插入顺序追加，
+ *                              env / export 打印时按这个顺序遍历
+ * - n_live                   : 仍然有效的变量数
+ * - slots / n_slots          : 哈希槽（线性探测），存 vars 的下标，
+ *                              或 ENV_SLOT_EMPTY / ENV_SLOT_DEAD
+ * - n_dead                   : 墓碑槽的数量（决定何时原地重建）
+ * - gen                      : 代数，每次 env_set / env_unset 加一
+ * - envp / envp_gen          : 缓存的 "KEY=VALUE" 数组及其对应的代数，
+ *                              见 env_envp
+ */
+typedef struct s_env
+{
+	t_env_var *vars;
+	int n_vars;
+	int cap_vars;
+	int n_live;
+	int *slots;
+	int n_slots;
+	int n_dead;
+	unsigned long gen;
+	char **envp;
+	unsigned long envp_gen;
+} t_env;
+
+unsigned int env_hash(const char *name, size_t len);
+t_env *env_create(char **envp);
+void env_destroy(t_env *env);
+int env_rebuild(t_env *env, int n_slots);
+
+t_env_var *env_find_n(t_env *env, const char *name, size_t len);
+t_env_var *env_find(t_env *env, const char *key);
+const char *env_get_n(t_env *env, const char *name, size_t len);
+const char *env_get(t_env *env, const char *key);
+int env_set(t_env *env, const char *key, const char *value);
+int env_unset(t_env *env, const char *key);
+t_env_var *env_next(t_env *env, int *it);
+char **env_envp(t_env *env);
+
+#endif
@@ -0,0 +1,288 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   env_map.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:05:31 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 14:05:31 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+/**
+ * env_hash
+ * ----------------
+ * 目的：
+ *   计算 name[0..len) 的 FNV-1a 哈希。按长度而不是 '\0' 结束，
+ *   这样 expander 可以直接拿命令行里的 "$NAME" 片段来查，不必先拷贝出来。
+ *   命令路径缓存（exec_hash.c）也用它。
+ */
+unsigned int env_hash(const char *name, size_t len)
+{
+	unsigned int h;
+	size_t i;
+
+	h = 2166136261u;
+	i = 0;
+	while (i < len)
+	{
+		h ^= (unsigned char)name[i];
+		h *= 16777619u;
+		i++;
+	}
+	return (h);
+}
+
+/**
+ * env_probe
+ * ----------------
+ * 目的：
+ *   线性探测查找 name[0..len)。
+ *
+ * 返回值：
+ *   - 找到：返回该变量所在的槽下标，并置 *found = 1
+ *   - 没找到：返回可以插入的槽下标（优先复用探测路径上的第一个墓碑），*found = 0
+ */
+static int env_probe(t_env *env, const char *name, size_t len,
+					 unsigned int h, int *found)
+{
+	int mask;
+	int s;
+	int first_dead;
+	t_env_var *v;
+
+	mask = env->n_slots - 1;
+	s = h & mask;
+	first_dead = -1;
+	*found = 0;
+	while (env->slots[s] != ENV_SLOT_EMPTY)
+	{
+		if (env->slots[s] == ENV_SLOT_DEAD)
+		{
+			if (first_dead < 0)
+				first_dead = s;
+		}
+		else
+		{
+			v = &env->vars[env->slots[s]];
+			if (v->hash == h && strncmp(v->key, name, len) == 0
+				&& v->key[len] == '\0')
+			{
+				*found = 1;
+				return (s);
+			}
+		}
+		s = (s + 1) & mask;
+	}
+	if (first_dead >= 0)
+		return (first_dead);
+	return (s);
+}
+
+/**
+ * env_find_n / env_find / env_get_n / env_get
+ * ----------------
+ * 目的：
+ *   按名字查变量（平均 O(1)）。_n 版本的名字不需要以 '\0' 结尾。
+ *   shell 自己读变量（PATH、MINISHELL_SPAWN、TIMEFORMAT 等）也经过这里，
+ *   统计里的变量查找次数（env_lookups）只算命令行里的 $VAR，记在展开里（env_value_ref）。
+ *
+ * 返回值：
+ *   - env_find*：变量本体，找不到为 NULL
+ *   - env_get* ：变量的值，找不到或没有值为 NULL
+ */
+t_env_var *env_find_n(t_env *env, const char *name, size_t len)
+{
+	int found;
+	int s;
+
+	if (!env || !name)
+		return (NULL);
+	s = env_probe(env, name, len, env_hash(name, len), &found);
+	if (!found)
+		return (NULL);
+	return (&env->vars[env->slots[s]]);
+}
+
+t_env_var *env_find(t_env *env, const char *key)
+{
+	if (!key)
+		return (NULL);
+	return (env_find_n(env, key, strlen(key)));
+}
+
+const char *env_get_n(t_env *env, const char *name, size_t len)
+{
+	t_env_var *v;
+
+	v = env_find_n(env, name, len);
+	if (!v)
+		return (NULL);
+	return (v->value);
+}
+
+const char *env_get(t_env *env, const char *key)
+{
+	if (!key)
+		return (NULL);
+	return (env_get_n(env, key, strlen(key)));
+}
+
+/**
+ * env_grow
+ * ----------------
+ * 目的：
+ *   在插入一个新变量之前，保证 vars 有空位、哈希表负载（含墓碑）不超过 1/2。
+ *
+ * 行为说明：
+ *   - vars 满了：容量翻倍（realloc 只挪指针，不拷贝字符串）
+ *   - 槽太满：有效变量多就把槽数翻倍，否则同样大小原地重建以清除墓碑
+ */
+static int env_grow(t_env *env)
+{
+	t_env_var *nv;
+	int cap;
+	int n_slots;
+
+	if (env->n_vars == env->cap_vars)
+	{
+		cap = env->cap_vars * 2;
+		if (cap < 16)
+			cap = 16;
+		nv = realloc(env->vars, sizeof(t_env_var) * cap);
+		if (!nv)
+			return (0);
+		env->vars = nv;
+		env->cap_vars = cap;
+	}
+	if ((env->n_live + env->n_dead + 1) * 2 <= env->n_slots)
+		return (1);
+	n_slots = env->n_slots;
+	while ((env->n_live + 1) * 2 > n_slots)
+		n_slots *= 2;
+	return (env_rebuild(env, n_slots));
+}
+
+/**
+ * env_set
+ * ----------------
+ * 目的：
+ *   设置变量（替代原来散落在 cd.c / export.c 中的查找 + 追加逻辑）。
+ *
+ * 参数：
+ *   - key   : 变量名（会被复制）
+ *   - value : 新值（会被复制）；NULL 表示“只有名字、没有值”
+ *
+ * 返回值：
+ *   - 1 成功 / 0 内存失败（原值保持不变）
+ *
+ * 行为说明：
+ *   已存在 → 原地替换值，插入顺序不变；
+ *   不存在 → 追加到 vars 末尾，并登记到哈希槽。
+ */
+int env_set(t_env *env, const char *key, const char *value)
+{
+	t_env_var *v;
+	char *dup;
+	int found;
+	int s;
+	unsigned int h;
+
+	dup = NULL;
+	if (value && !(dup = strdup(value)))
+		return (0);
+	v = env_find(env, key);
+	if (v)
+	{
+		free(v->value);
+		v->value = dup;
+		env->gen++;
+		return (1);
+	}
+	if (!env_grow(env))
+	{
+		free(dup);
+		return (0);
+	}
+	h = env_hash(key, strlen(key));
+	s = env_probe(env, key, strlen(key), h, &found);
+	v = &env->vars[env->n_vars];
+	v->key = strdup(key);
+	if (!v->key)
+	{
+		free(dup);
+		return (0);
+	}
+	v->value = dup;
+	v->hash = h;
+	v->alive = 1;
+	if (env->slots[s] == ENV_SLOT_DEAD)
+		env->n_dead--;
+	env->slots[s] = env->n_vars++;
+	env->n_live++;
+	env->gen++;
+	return (1);
+}
+
+/**
+ * env_unset
+ * ----------------
+ * 目的：
+ *   删除变量（替代 unset.c 中的链表删除）。
+ *
+ * 返回值：
+ *   - 1 删除了 / 0 本来就不存在
+ *
+ * 行为说明：
+ *   槽位改成墓碑，vars 中的位置标记为失效；失效项过多时压缩一次，
+ *   保证遍历和探测的代价都与有效变量数成正比。
+ */
+int env_unset(t_env *env, const char *key)
+{
+	int found;
+	int s;
+	t_env_var *v;
+
+	if (!env || !key)
+		return (0);
+	s = env_probe(env, key, strlen(key), env_hash(key, strlen(key)), &found);
+	if (!found)
+		return (0);
+	v = &env->vars[env->slots[s]];
+	free(v->key);
+	free(v->value);
+	v->key = NULL;
+	v->value = NULL;
+	v->alive = 0;
+	env->slots[s] = ENV_SLOT_DEAD;
+	env->n_dead++;
+	env->n_live--;
+	env->gen++;
+	if (env->n_vars > 2 * env->n_live + 16)
+		env_rebuild(env, env->n_slots);
+	return (1);
+}
+
+/**
+ * env_next
+ * ----------------
+ * 目的：
+ *   按插入顺序遍历有效变量。*it 从 0 开始，遍历结束返回 NULL。
+ *
+ * 用法：
+ *   int it = 0;
+ *   while ((v = env_next(env, &it)))
+ *       ...
+ */
+t_env_var *env_next(t_env *env, int *it)
+{
+	while (env && *it < env->n_vars)
+	{
+		if (env->vars[(*it)++].alive)
+			return (&env->vars[*it - 1]);
+	}
+	return (NULL);
+}
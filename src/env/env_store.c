@@ -0,0 +1,204 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   env_store.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 14:05:31 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 14:05:31 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+/**
+ * env_rebuild
+ * ----------------
+ * 目的：
+ *   把 vars 中已 unset 的空位压缩掉，并按 n_slots 个槽重新建立哈希索引。
+ *
+ * 参数：
+ *   - env     : 变量表
+ *   - n_slots : 新的槽数（2 的幂，且大于 2 倍有效变量数）
+ *
+ * 返回值：
+ *   - 1 成功 / 0 内存失败（原表保持不变）
+ *
+ * 行为说明：
+ *   1. 先分配新槽数组，全部置为 ENV_SLOT_EMPTY
+ *   2. 按顺序把仍然有效的变量往前挪，保持插入顺序
+ *   3. 用保存的 hash 线性探测插入新槽，墓碑计数清零
+ */
+int env_rebuild(t_env *env, int n_slots)
+{
+	int *slots;
+	int i;
+	int n;
+	unsigned int h;
+
+	slots = malloc(sizeof(int) * n_slots);
+	if (!slots)
+		return (0);
+	i = 0;
+	while (i < n_slots)
+		slots[i++] = ENV_SLOT_EMPTY;
+	n = 0;
+	i = 0;
+	while (i < env->n_vars)
+	{
+		if (env->vars[i].alive)
+		{
+			env->vars[n] = env->vars[i];
+			h = env->vars[n].hash & (n_slots - 1);
+			while (slots[h] != ENV_SLOT_EMPTY)
+				h = (h + 1) & (n_slots - 1);
+			slots[h] = n;
+			n++;
+		}
+		i++;
+	}
+	free(env->slots);
+	env->slots = slots;
+	env->n_slots = n_slots;
+	env->n_vars = n;
+	env->n_live = n;
+	env->n_dead = 0;
+	return (1);
+}
+
+/**
+ * env_create
+ * ----------------
+ * 目的：
+ *   用进程启动时的 envp 建立变量表（替代原来的 init_env 链表）。
+ *
+ * 返回值：
+ *   - 新的变量表；内存失败返回 NULL
+ *
+ * 行为说明：
+ *   没有 '=' 的条目直接忽略；同名变量以后出现的为准（env_set 覆盖）。
+ */
+t_env *env_create(char **envp)
+{
+	t_env *env;
+	char *equal;
+	char *key;
+	int i;
+
+	env = ft_calloc(1, sizeof(t_env));
+	if (!env)
+		return (NULL);
+	env->envp_gen = (unsigned long)-1;
+	if (!env_rebuild(env, ENV_INIT_SLOTS))
+	{
+		free(env);
+		return (NULL);
+	}
+	i = 0;
+	while (envp && envp[i])
+	{
+		equal = strchr(envp[i], '=');
+		if (equal)
+		{
+			key = strndup(envp[i], equal - envp[i]);
+			if (!key || !env_set(env, key, equal + 1))
+			{
+				free(key);
+				env_destroy(env);
+				return (NULL);
+			}
+			free(key);
+		}
+		i++;
+	}
+	return (env);
+}
+
+/**
+ * env_destroy
+ * ----------------
+ * 目的：
+ *   释放变量表及其中所有字符串（替代原来的 free_env）。
+ */
+void env_destroy(t_env *env)
+{
+	int i;
+
+	if (!env)
+		return ;
+	i = 0;
+	while (i < env->n_vars)
+	{
+		if (env->vars[i].alive)
+		{
+			free(env->vars[i].key);
+			free(env->vars[i].value);
+		}
+		i++;
+	}
+	free(env->vars);
+	free(env->slots);
+	free(env->envp);
+	free(env);
+}
+
+/**
+ * env_envp
+ * ----------------
+ * 目的：
+ *   得到传给 execve 的 "KEY=VALUE" 数组（以 NULL 结尾）。
+ *
+ * 返回值：
+ *   - 数组（归变量表所有，调用者不要 free）；内存失败返回 NULL
+ *
+ * 行为说明：
+ *   1. 代数 gen 与缓存时的 envp_gen 相同 → 变量没变过，直接返回缓存
+ *   2. 否则先算出总大小，一次 malloc 同时放下指针数组和所有字符串，
+ *      按插入顺序填好；没有值的变量（只 export 了名字）不进入子进程环境
+ *   3. 释放旧缓存只需一次 free
+ *   因此提示符循环里不再有任何逐变量的字符串拼接，只有 export/unset/cd
+ *   真正改动之后的第一次 exec 才会重建。
+ */
+char **env_envp(t_env *env)
+{
+	t_env_var *v;
+	size_t bytes;
+	char **arr;
+	char *p;
+	int it;
+	int n;
+
+	if (env->envp && env->envp_gen == env->gen)
+		return (env->envp);
+	bytes = 0;
+	n = 0;
+	it = 0;
+	while ((v = env_next(env, &it)))
+	{
+		if (!v->value)
+			continue ;
+		bytes += strlen(v->key) + strlen(v->value) + 2;
+		n++;
+	}
+	arr = malloc(sizeof(char *) * (n + 1) + bytes);
+	if (!arr)
+		return (NULL);
+	p = (char *)(arr + n + 1);
+	n = 0;
+	it = 0;
+	while ((v = env_next(env, &it)))
+	{
+		if (!v->value)
+			continue ;
+		arr[n++] = p;
+		p += ft_strlcpy(p, v->key, strlen(v->key) + 1);
+		*p++ = '=';
+		p += ft_strlcpy(p, v->value, strlen(v->value) + 1) + 1;
+	}
+	arr[n] = NULL;
+	free(env->envp);
+	env->envp = arr;
+	env->envp_gen = env->gen;
+	return (arr);
+}
@@ -0,0 +1,268 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   event.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:40:12 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 19:40:12 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+
+// 事件核心本身（每个进程一份，fork 后由 ev_core 重新建立 fd）
+static t_event	*ev_state(void)
+{
+	static t_event	core = {.owner = 0, .epfd = -1, .sigfd = -1};
+
+	return (&core);
+}
+
+// 取得本进程的事件核心，第一次使用时建立 signalfd 与 epoll 实例。
+// 建立失败时 epfd 为 -1，等待退回 sigwaitinfo（见 ev_next）
+static t_event	*ev_core(void)
+{
+	t_event				*core;
+	sigset_t			mask;
+	struct epoll_event	e;
+
+	core = ev_state();
+	if (core->owner == getpid())
+		return (core);
+	if (core->epfd >= 0)
+		close(core->epfd);
+	if (core->sigfd >= 0)
+		close(core->sigfd);
+	core->owner = getpid();
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigaddset(&mask, SIGINT);
+	core->sigfd = signalfd(-1, &mask, SFD_CLOEXEC | SFD_NONBLOCK);
+	core->epfd = epoll_create1(EPOLL_CLOEXEC);
+	e.events = EPOLLIN;
+	e.data.fd = core->sigfd;
+	if (core->sigfd < 0 || core->epfd < 0
+		|| epoll_ctl(core->epfd, EPOLL_CTL_ADD, core->sigfd, &e) < 0)
+	{
+		if (core->sigfd >= 0)
+			close(core->sigfd);
+		if (core->epfd >= 0)
+			close(core->epfd);
+		core->sigfd = -1;
+		core->epfd = -1;
+	}
+	return (core);
+}
+
+// 阻塞 SIGCHLD 与 SIGINT：只在等待期间阻塞，它们从 signalfd 读出。
+// 平时不阻塞，spawn 出去的子进程不会继承被阻塞的掩码
+static void	ev_block(sigset_t *old)
+{
+	sigset_t	mask;
+
+	sigemptyset(&mask);
+	sigaddset(&mask, SIGCHLD);
+	sigaddset(&mask, SIGINT);
+	sigprocmask(SIG_BLOCK, &mask, old);
+}
+
+/**
+ * ev_next
+ * ----------------
+ * 目的：
+ *   等待下一个事件（调用者已阻塞 SIGCHLD / SIGINT）。
+ *   signalfd 里积压的信号全部读掉，同一时刻的多个 SIGCHLD 合并成一次收割。
+ *
+ * 返回值：
+ *   - SIGINT : 收到 Ctrl+C（优先于其他事件）
+ *   - 1      : fd 可读（fd 为 -1 时不监视）
+ *   - 0      : 有子进程结束，或被其他信号打断
+ */
+static int	ev_next(t_event *core, int fd)
+{
+	struct epoll_event		e[2];
+	struct signalfd_siginfo	si;
+	siginfo_t				info;
+	sigset_t				mask;
+	int						rc;
+	int						n;
+
+	if (core->epfd < 0)
+	{
+		if (fd >= 0)
+			return (1);
+		sigemptyset(&mask);
+		sigaddset(&mask, SIGCHLD);
+		sigaddset(&mask, SIGINT);
+		if (sigwaitinfo(&mask, &info) == SIGINT)
+			return (SIGINT);
+		return (0);
+	}
+	rc = 0;
+	n = epoll_wait(core->epfd, e, 2, -1);
+	while (n-- > 0)
+		if (e[n].data.fd == fd)
+			rc = 1;
+	while (read(core->sigfd, &si, sizeof(si)) == (ssize_t)sizeof(si))
+	{
+		if (si.ssi_signo == SIGINT)
+			rc = SIGINT;
+		else // 同时结束的子进程的 SIGCHLD 会合并，只记下送达的这一个
+			trace_child('i', "exit", si.ssi_pid, "status", si.ssi_status);
+	}
+	return (rc);
+}
+
+// 登记一张作业表：此后结束的子进程若属于它，由 ev_reap 记到它的作业上。
+// 登记满时返回 0
+int	ev_watch(t_jobs *jobs)
+{
+	t_event	*core;
+
+	core = ev_state();
+	if (core->n_tables == EV_MAX_TABLES)
+		return (0);
+	core->tables[core->n_tables++] = jobs;
+	return (1);
+}
+
+// 注销作业表（作业表离开作用域前必须调用）
+void	ev_unwatch(t_jobs *jobs)
+{
+	t_event	*core;
+	int		i;
+
+	core = ev_state();
+	i = 0;
+	while (i < core->n_tables && core->tables[i] != jobs)
+		i++;
+	if (i == core->n_tables)
+		return ;
+	core->n_tables--;
+	while (i < core->n_tables)
+	{
+		core->tables[i] = core->tables[i + 1];
+		i++;
+	}
+}
+
+/**
+ * ev_reap
+ * ----------------
+ * 目的：
+ *   收割所有已经结束的子进程（wait4(-1, WNOHANG)，不按 pid 逐个轮询），
+ *   连同资源用量按 pid 分发给登记过的作业表。不属于任何作业表的子进程直接丢弃。
+ *
+ * 返回值：
+ *   - 分发到作业表的子进程个数
+ */
+int	ev_reap(void)
+{
+	t_event			*core;
+	struct rusage	ru;
+	pid_t			pid;
+	int				st;
+	int				n;
+	int				i;
+
+	core = ev_state();
+	n = 0;
+	while (1)
+	{
+		pid = wait4(-1, &st, WNOHANG, &ru);
+		if (pid <= 0)
+			break ;
+		trace_child('E', "reap", pid, "status", st);
+		spawn_reaped(pid, st);
+		i = 0;
+		while (i < core->n_tables && !job_done(core->tables[i], pid, st, &ru))
+			i++;
+		n += (i < core->n_tables);
+	}
+	return (n);
+}
+
+/**
+ * ev_wait
+ * ----------------
+ * 目的：
+ *   等到 done(arg) 成立：每个事件之后先收割、分发，再问等待者是否满足。
+ *   等待前先收割一次，进入之前就已结束的子进程（僵尸）不会漏掉。
+ *
+ * 参数：
+ *   - intr : 为 1 时 Ctrl+C 结束等待（wait、parallel）；
+ *            为 0 时忽略（前台命令自己收到 SIGINT，等它结束即可）
+ *
+ * 返回值：
+ *   - 0 : done 成立；-1 : 被 Ctrl+C 打断
+ */
+int	ev_wait(int (*done)(void *), void *arg, int intr)
+{
+	t_event		*core;
+	sigset_t	old;
+	int			rc;
+
+	ev_block(&old);
+	core = ev_core();
+	rc = 0;
+	while (1)
+	{
+		ev_reap();
+		if (done(arg))
+			break ;
+		if (intr && g_signal == SIGINT)
+			rc = -1;
+		else if (ev_next(core, -1) == SIGINT && intr)
+			rc = -1;
+		if (rc < 0)
+			break ;
+	}
+	if (rc < 0)
+		g_signal = 0;
+	sigprocmask(SIG_SETMASK, &old, NULL);
+	return (rc);
+}
+
+/**
+ * ev_wait_fd
+ * ----------------
+ * 目的：
+ *   等到 fd 可读（交互输入、终端上的 heredoc），或者 Ctrl+C。
+ *   Ctrl+C 作为事件返回给调用者处理，不在信号处理函数里打断 read 或 readline。
+ *   等待期间结束的后台子进程顺带收割。
+ *
+ * 返回值：
+ *   - 1 : fd 可读（或无法监视，交给随后的 read 阻塞）；-1 : Ctrl+C
+ */
+int	ev_wait_fd(int fd)
+{
+	t_event				*core;
+	struct epoll_event	e;
+	sigset_t			old;
+	int					rc;
+
+	ev_block(&old);
+	core = ev_core();
+	rc = 1;
+	e.events = EPOLLIN;
+	e.data.fd = fd;
+	if (g_signal == SIGINT)
+		rc = SIGINT;
+	else if (core->epfd >= 0
+		&& epoll_ctl(core->epfd, EPOLL_CTL_ADD, fd, &e) == 0)
+	{
+		while ((rc = ev_next(core, fd)) == 0)
+			ev_reap();
+		epoll_ctl(core->epfd, EPOLL_CTL_DEL, fd, NULL);
+	}
+	if (rc == SIGINT)
+		g_signal = 0;
+	sigprocmask(SIG_SETMASK, &old, NULL);
+	if (rc == SIGINT)
+		return (-1);
+	return (1);
+}
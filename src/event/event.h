@@ -0,0 +1,46 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   event.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:40:12 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 19:40:12 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <sys/types.h>
+
+/* 同时登记到事件核心的作业表上限（主作业表、parallel、前台等待） */
+#define EV_MAX_TABLES 8
+
+/**
+ * s_event
+ * ----------------
+ * 事件核心：一个 epoll 实例监视 signalfd（SIGCHLD 与 SIGINT），
+ * 子进程结束与 Ctrl+C 都作为事件读出，不在信号处理函数里做任何事。
+ * 结束的子进程按 pid 分发给登记过的作业表（tables），
+ * 由等待它的一方（前台命令、wait、parallel）检查自己的作业状态。
+ * - owner : 建立 epfd / sigfd 的进程；fork 出的子 shell 不共用父进程的 epoll 实例，
+ *           第一次使用时重新建立
+ */
+typedef struct s_event
+{
+	pid_t owner;
+	int epfd;
+	int sigfd;
+	struct s_jobs *tables[EV_MAX_TABLES];
+	int n_tables;
+}	t_event;
+
+int		ev_watch(struct s_jobs *jobs);
+void	ev_unwatch(struct s_jobs *jobs);
+int		ev_reap(void);
+int		ev_wait(int (*done)(void *), void *arg, int intr);
+int		ev_wait_fd(int fd);
+
+#endif
@@ -1,29 +1,35 @@
 #include "../../../include/minishell.h"
 
 // 检测命令是否为内置命令，返回 1 如果是，否则 0
+// 必须整名匹配：按前缀比较会把 "envsubst"、"cdx" 之类的外部命令当成内建
 int is_builtin(const char *cmd)
 {
     if (!cmd)
         return 0;
-    return (!ft_strncmp(cmd, "cd", 2) ||
-            !ft_strncmp(cmd, "echo", 4) ||
-            !ft_strncmp(cmd, "pwd", 3) ||
-            !ft_strncmp(cmd, "exit", 4) ||
-            !ft_strncmp(cmd, "export", 6) ||
-            !ft_strncmp(cmd, "unset", 5) ||
-            !ft_strncmp(cmd, "env", 3));
+    return (!strcmp(cmd, "cd") ||
+            !strcmp(cmd, "echo") ||
+            !strcmp(cmd, "pwd") ||
+            !strcmp(cmd, "exit") ||
+            !strcmp(cmd, "export") ||
+            !strcmp(cmd, "unset") ||
+            !strcmp(cmd, "env") ||
+            !strcmp(cmd, "hash") ||
+            !strcmp(cmd, "wait") ||
+            !strcmp(cmd, "jobs") ||
+            !strcmp(cmd, "parallel") ||
+            !strcmp(cmd, "stats"));
 }
 
 // 执行内置命令，返回退出码
-int exec_builtin(ast *node, t_env **env)
+int exec_builtin(ast *node, t_env *env, t_minishell *minishell)
 {
     if (!node || !node->argv || !node->argv[0])
         return 1;
 
     // 在这里根据命令名执行
-    if (ft_strncmp(node->argv[0], "cd", 2) == 0)
+    if (strcmp(node->argv[0], "cd") == 0)
         return ft_cd(node->argv, env);
-    else if (ft_strncmp(node->argv[0], "echo", 4) == 0)
+    else if (strcmp(node->argv[0], "echo") == 0)
         return ft_echo(node->argv);
     else if (strcmp(node->argv[0], "pwd") == 0)
         return builtin_pwd();
@@ -31,11 +37,21 @@ int exec_builtin(ast *node, t_env **env)
         return builtin_export(node->argv, env);
 
     else if (strcmp(node->argv[0], "env") == 0)
-        return builtin_env(node->argv, *env);
+        return builtin_env(node->argv, env);
     else if (strcmp(node->argv[0], "exit") == 0)
         return builtin_exit(node->argv);
     else if (strcmp(node->argv[0], "unset") == 0)
-        builtin_unset(node->argv, env);
+        return builtin_unset(node->argv, env);
+    else if (strcmp(node->argv[0], "hash") == 0)
+        return builtin_hash(node->argv, minishell);
+    else if (strcmp(node->argv[0], "wait") == 0)
+        return builtin_wait(node->argv, minishell);
+    else if (strcmp(node->argv[0], "jobs") == 0)
+        return builtin_jobs(node->argv, minishell);
+    else if (strcmp(node->argv[0], "parallel") == 0)
+        return builtin_parallel(node->argv, minishell);
+    else if (strcmp(node->argv[0], "stats") == 0)
+        return builtin_stats(node->argv);
     // 其它内置命令类似处理
     return 1; // 未知内置
 }
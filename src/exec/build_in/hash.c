@@ -0,0 +1,59 @@
+#include "../../../include/minishell.h"
+#include "../../../libft//libft.h"
+
+// 按 bash 的格式列出缓存中找到了路径的命令
+static void print_hash(t_cmd_cache *c)
+{
+    int printed = 0;
+
+    for (int i = 0; i < c->n_slots; i++)
+    {
+        if (!c->slots[i].name || !c->slots[i].path)
+            continue;
+        if (!printed++)
+            printf("hits\tcommand\n");
+        printf("%4u\t%s\n", c->slots[i].hits, c->slots[i].path);
+    }
+    if (!printed)
+        printf("hash: hash table empty\n");
+}
+
+// hash            列出缓存
+// hash -r         清空缓存
+// hash name ...   搜索 PATH 并加入缓存
+int builtin_hash(char **argv, t_minishell *minishell)
+{
+    int status = 0;
+    int i = 1;
+    t_cmd_entry *e;
+
+    cmd_cache_sync(minishell); // PATH 改过的话先丢掉旧结果
+    if (!argv[1])
+    {
+        print_hash(&minishell->cmds);
+        return 0;
+    }
+    if (strcmp(argv[1], "-r") == 0)
+    {
+        cmd_cache_clear(&minishell->cmds);
+        i++;
+    }
+    for (; argv[i]; i++)
+    {
+        if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "hash: %s: invalid option\n", argv[i]);
+            fprintf(stderr, "hash: usage: hash [-r] [name ...]\n");
+            return 2;
+        }
+        if (strchr(argv[i], '/'))
+            continue; // 带路径的名字不需要缓存
+        e = cmd_cache_add(minishell, argv[i]);
+        if (!e || !e->path)
+        {
+            fprintf(stderr, "hash: %s: not found\n", argv[i]);
+            status = 1;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,241 @@
+#include "../../../include/minishell.h"
+#include <errno.h>
+
+// -j 的值：整个参数必须是不小于 1 的十进制整数，否则报错返回 0
+static int parse_slots(const char *s, int *slots)
+{
+    char *end;
+    long v;
+
+    if (!s)
+        return (fprintf(stderr, "parallel: -j: option requires an argument\n"), 0);
+    errno = 0;
+    v = strtol(s, &end, 10);
+    if (!*s || *end || errno || v < 1 || v > INT_MAX)
+        return (fprintf(stderr, "parallel: -j: %s: invalid number\n", s), 0);
+    *slots = (int)v;
+    return 1;
+}
+
+// 解析选项：parallel [-j N] 命令模板 ... [::: 输入 ...]
+// 不给 -j 时按在线 CPU 数。出错返回 0
+static int parse_opts(char **argv, t_pool *p)
+{
+    int i = 1;
+
+    p->slots = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    while (argv[i] && strncmp(argv[i], "-j", 2) == 0)
+    {
+        if (!parse_slots(argv[i][2] ? argv[i] + 2 : argv[++i], &p->slots))
+            return 0;
+        i++;
+    }
+    if (p->slots <= 0)
+        p->slots = 1;
+    p->tmpl = argv + i;
+    while (argv[i] && strcmp(argv[i], ":::") != 0)
+        i++;
+    if (argv[i])
+    {
+        argv[i] = NULL; // 模板到此为止（argv 在本行 arena 中，可以改）
+        p->args = argv + i + 1;
+    }
+    return (p->tmpl[0] != NULL);
+}
+
+// 取下一项输入：::: 之后的参数，或标准输入的一行（跳过空行）
+static int next_input(t_pool *p, const char **s, size_t *len)
+{
+    t_line l;
+
+    if (p->args)
+    {
+        if (!*p->args)
+            return 0;
+        *s = *p->args++;
+        *len = strlen(*s);
+        return 1;
+    }
+    while (rd_line(&p->in, &l) > 0)
+    {
+        if (l.len == 0)
+            continue;
+        *s = l.ptr;
+        *len = l.len;
+        return 1;
+    }
+    return 0;
+}
+
+// 把输入填进一个模板单词：每个 {} 换成输入，结果放进池的 arena；
+// 单词里没有 {} 时原样使用
+static char *fill_word(t_pool *p, t_strbuf *sb, const char *w, const char *in,
+    size_t len)
+{
+    const char *hole;
+
+    if (!strstr(w, "{}"))
+        return (char *)w;
+    sb_reset(sb);
+    while ((hole = strstr(w, "{}")))
+    {
+        if (!sb_append_span(sb, w, hole - w) || !sb_append_span(sb, in, len))
+            return NULL;
+        w = hole + 2;
+    }
+    if (!sb_append_span(sb, w, strlen(w)))
+        return NULL;
+    return arena_strndup(p->arena, sb->buf, sb->len);
+}
+
+// 由模板生成一项的 argv：模板各单词已经过本行的展开与去引号，
+// 一个单词仍是一个参数，不再按 shell 语法重新解析；
+// 模板里没有 {} 时把输入追加为最后一个参数
+static char **build_argv(t_pool *p, t_strbuf *sb, const char *in, size_t len)
+{
+    char **argv;
+    int n = 0;
+    int used = 0;
+
+    while (p->tmpl[n])
+        n++;
+    argv = arena_alloc(p->arena, sizeof(char *) * (n + 2));
+    if (!argv)
+        return NULL;
+    for (int i = 0; i < n; i++)
+    {
+        used |= (strstr(p->tmpl[i], "{}") != NULL);
+        argv[i] = fill_word(p, sb, p->tmpl[i], in, len);
+        if (!argv[i])
+            return NULL;
+    }
+    if (!used && !(argv[n++] = arena_strndup(p->arena, in, len)))
+        return NULL;
+    argv[n] = NULL;
+    return argv;
+}
+
+// 启动一项，不等待：argv 包成一个命令节点交给 start_async，
+// 与后台命令一样经过命令路径缓存与 spawn 层（内建命令 fork 一份 shell 执行）
+static int start_item(t_pool *p, t_minishell *minishell, const char *in,
+    size_t len)
+{
+    pid_t *pids = NULL;
+    t_job *job;
+    ast node;
+    int count = 0;
+    int status = 0;
+
+    ft_bzero(&node, sizeof(node));
+    node.type = NODE_CMD;
+    node.argv = build_argv(p, &minishell->expand_buf, in, len);
+    if (node.argv)
+        pids = start_async(&node, minishell->env, minishell, &count, &status);
+    arena_reset(p->arena);
+    if (!pids)
+        return 0;
+    job = job_add(&p->run, pids, count, strndup(in, len));
+    if (job && pids[count - 1] < 0)
+        job->status = status;
+    return (job != NULL);
+}
+
+// 处理已经结束的项：失败的逐个报告，从池中删除
+static void collect(t_pool *p)
+{
+    t_job *j;
+    t_job *next;
+
+    for (j = p->run.head; j; j = next)
+    {
+        next = j->next;
+        if (j->n_live > 0)
+            continue;
+        if (j->status)
+        {
+            fprintf(stderr, "parallel: %s: exit status %d\n",
+                j->cmd ? j->cmd : "", j->status);
+            p->failed++;
+        }
+        job_remove(&p->run, j);
+    }
+}
+
+static int running(t_pool *p)
+{
+    int n = 0;
+
+    for (t_job *j = p->run.head; j; j = j->next)
+        n++;
+    return n;
+}
+
+/**
+ * builtin_parallel
+ * ----------------
+ * 用法：
+ *   parallel [-j N] 命令模板 ... [::: 输入 ...]
+ *   没有 ::: 时从标准输入按行读取输入。
+ *
+ * 目的：
+ *   对每项输入执行一次模板命令，最多同时运行 N 项（默认在线 CPU 数）；
+ *   有空位就立刻分发下一项，不按批等待。每项的 argv 直接由展开后的模板
+ *   单词生成（引号的结果保持不变），命令查找与启动走 shell 自己的实现
+ *   （start_async：路径缓存、spawn 层），不经过 xargs。
+ *   各项是前台进程：Ctrl+C 终止正在运行的项并停止分发。
+ *
+ * 返回值：
+ *   - 全部成功为 0；否则为失败的项数（超过 100 记为 101，与 GNU parallel 相同）
+ *   - 选项或模板错误为 2；被 Ctrl+C 打断为 130
+ */
+int builtin_parallel(char **argv, t_minishell *minishell)
+{
+    t_pool p;
+    const char *in;
+    size_t len;
+    int interrupted = 0;
+
+    ft_bzero(&p, sizeof(p));
+    if (!parse_opts(argv, &p))
+    {
+        fprintf(stderr, "parallel: usage: parallel [-j N] command ... [::: arg ...]\n");
+        return 2;
+    }
+    p.arena = arena_new();
+    if (!p.arena || (!p.args && !rd_init(&p.in, STDIN_FILENO, 0))
+        || !ev_watch(&p.run))
+    {
+        perror("parallel");
+        if (!p.args)
+            rd_free(&p.in);
+        arena_destroy(p.arena);
+        return 1;
+    }
+    g_signal = 0;
+    setup_parent_exec_signals();
+    while (!p.stop || p.run.head)
+    {
+        while (!p.stop && running(&p) < p.slots)
+        {
+            if (!next_input(&p, &in, &len))
+                p.stop = 1;
+            else if (!start_item(&p, minishell, in, len))
+                p.stop = p.error = 1;
+        }
+        if (p.run.head && jobs_reap(&p.run, 1) < 0)
+        {
+            g_signal = 0;
+            p.stop = interrupted = 1;
+        }
+        collect(&p);
+    }
+    if (!p.args)
+        rd_free(&p.in);
+    arena_destroy(p.arena);
+    ev_unwatch(&p.run);
+    if (interrupted)
+        return 130;
+    if (p.error)
+        return (fprintf(stderr, "parallel: cannot run command template\n"), 2);
+    return (p.failed > 100 ? 101 : p.failed);
+}
@@ -0,0 +1,29 @@
+#include "../../../include/minishell.h"
+
+// stats       以表格列出各阶段的延迟分布与计数器
+// stats -j    输出一行 JSON（延迟单位为纳秒），便于脚本收集
+// stats -r    输出之后清零（可与 -j 连用：stats -j -r）
+int builtin_stats(char **argv)
+{
+    int json = 0;
+    int reset = 0;
+    int i;
+
+    for (i = 1; argv[i]; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0)
+            json = 1;
+        else if (strcmp(argv[i], "-r") == 0)
+            reset = 1;
+        else
+        {
+            fprintf(stderr, "stats: %s: invalid option\n", argv[i]);
+            fprintf(stderr, "stats: usage: stats [-j] [-r]\n");
+            return 2;
+        }
+    }
+    stats_print(stdout, json);
+    if (reset)
+        stats_reset();
+    return 0;
+}
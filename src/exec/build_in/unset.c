@@ -2,48 +2,6 @@
 #include "../../../libft//libft.h"
 
 
-// 删除指定的环境变量
-static void delete_env_var(t_env **env, const char *key)
-{
-    t_env *temp = *env;
-    t_env *prev = NULL;
-
-    // 如果链表为空
-    if (!temp)
-    {
-        return;
-    }
-
-    // 如果要删除的是头节点
-    if (strcmp(temp->key, key) == 0)
-    {
-        *env = temp->next; // 让头节点指向下一个节点
-        free(temp->key);
-        free(temp->value);
-        free(temp);
-        return;
-    }
-
-    // 否则遍历链表找到需要删除的节点
-    while (temp != NULL && strcmp(temp->key, key) != 0)
-    {
-        prev = temp;
-        temp = temp->next;
-    }
-
-    // 如果未找到该环境变量
-    if (temp == NULL)
-    {
-        return;
-    }
-
-    // 删除该节点
-    prev->next = temp->next;
-    free(temp->key);
-    free(temp->value);
-    free(temp);
-}
-
 int is_valid_identifier(const char *s)
 {
     int i = 0;
@@ -65,7 +23,7 @@ int is_valid_identifier(const char *s)
 }
 
 
-int builtin_unset(char **argv, t_env **env)
+int builtin_unset(char **argv, t_env *env)
 {
     int status = 0;
 
@@ -82,7 +40,7 @@ int builtin_unset(char **argv, t_env **env)
         else
         {
             // 找不到变量也没关系
-            delete_env_var(env, argv[i]);
+            env_unset(env, argv[i]);
         }
     }
     return status;
@@ -0,0 +1,119 @@
+#include "../../../include/minishell.h"
+
+// 按操作数找作业：%n 是作业号，否则是作业中任一进程的 pid
+static t_job *find_job(t_jobs *jobs, const char *arg)
+{
+    char *end;
+    long v;
+
+    v = strtol(arg + (arg[0] == '%'), &end, 10);
+    if (end == arg + (arg[0] == '%') || *end || v <= 0)
+        return NULL;
+    for (t_job *j = jobs->head; j; j = j->next)
+    {
+        if (arg[0] == '%' && j->id == v)
+            return j;
+        for (int k = 0; arg[0] != '%' && k < j->n_pids; k++)
+            if (j->pids[k] == v || j->pids[k] == -v)
+                return j;
+    }
+    return NULL;
+}
+
+// 等一个作业结束，返回它的退出码并从表中删除；被 Ctrl+C 打断返回 130
+static int wait_job(t_jobs *jobs, t_job *job)
+{
+    int status;
+
+    while (job->n_live > 0)
+        if (jobs_reap(jobs, 1) < 0)
+            return 130;
+    status = job->status;
+    job_remove(jobs, job);
+    return status;
+}
+
+// wait -n：等下一个结束的作业（已经结束、还没报告的优先），返回它的退出码
+static int wait_next(t_jobs *jobs)
+{
+    t_job *j;
+
+    jobs_reap(jobs, 0);
+    while (1)
+    {
+        for (j = jobs->head; j; j = j->next)
+            if (j->n_live == 0)
+                return wait_job(jobs, j);
+        if (!jobs->head)
+            return 127;
+        if (jobs_reap(jobs, 1) < 0)
+            return 130;
+    }
+}
+
+// wait            等所有后台作业结束，返回 0
+// wait -n         等下一个作业结束，返回它的退出码（没有作业时 127）
+// wait id ...     等指定的作业（pid 或 %作业号），返回最后一个的退出码
+// 等待期间 Ctrl+C 打断等待，返回 130
+int builtin_wait(char **argv, t_minishell *minishell)
+{
+    t_jobs *jobs = &minishell->jobs;
+    t_job *job;
+    int status = 0;
+    int i = 1;
+
+    g_signal = 0;
+    setup_parent_exec_signals();
+    if (argv[1] && strcmp(argv[1], "-n") == 0 && !argv[2])
+        status = wait_next(jobs);
+    else if (argv[1] && argv[1][0] == '-')
+    {
+        fprintf(stderr, "wait: %s: invalid option\n", argv[1]);
+        fprintf(stderr, "wait: usage: wait [-n] [id ...]\n");
+        return 2;
+    }
+    else if (!argv[1])
+    {
+        while (jobs->head && status != 130)
+            status = wait_job(jobs, jobs->head);
+        if (status != 130)
+            status = 0;
+    }
+    for (; argv[1] && argv[1][0] != '-' && argv[i] && status != 130; i++)
+    {
+        job = find_job(jobs, argv[i]);
+        if (job)
+            status = wait_job(jobs, job);
+        else if (jobs->pruned_pid > 0 && atoi(argv[i]) == jobs->pruned_pid
+            && argv[i][0] != '%')
+            status = jobs->pruned_status; // 已经结束并被清理的 $!
+        else
+        {
+            fprintf(stderr, "minishell: wait: %s: no such job\n", argv[i]);
+            status = 127;
+        }
+    }
+    g_signal = 0;
+    return status;
+}
+
+// jobs     列出作业表，已结束的报告一次后删除
+// jobs -p  只列出各作业第一个进程的 pid
+int builtin_jobs(char **argv, t_minishell *minishell)
+{
+    if (argv[1] && strcmp(argv[1], "-p") == 0 && !argv[2])
+    {
+        jobs_reap(&minishell->jobs, 0);
+        for (t_job *j = minishell->jobs.head; j; j = j->next)
+            printf("%d\n", j->pids[0] < 0 ? -j->pids[0] : j->pids[0]);
+        return 0;
+    }
+    if (argv[1])
+    {
+        fprintf(stderr, "jobs: %s: invalid option\n", argv[1]);
+        fprintf(stderr, "jobs: usage: jobs [-p]\n");
+        return 2;
+    }
+    jobs_notify(&minishell->jobs, 1);
+    return 0;
+}
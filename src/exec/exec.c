@@ -1,4 +1,5 @@
 #include "../../include/minishell.h"
+#include <errno.h>
 
 int apply_redirs(t_redir *r)
 {
@@ -119,7 +120,7 @@ static int apply_redirs_nocmd(t_redir *r)
     return 0;
 }
 
-static void close_heredoc_fds(t_redir *r)
+void close_heredoc_fds(t_redir *r)
 {
     while (r)
     {
@@ -132,11 +133,138 @@ static void close_heredoc_fds(t_redir *r)
     }
 }
 
-// 执行命令节点（fork + exec 或内建）
-static int exec_cmd_node(ast *n, t_env **env, t_minishell *minishell)
+// 把 waitpid 得到的状态换算成退出码，被信号终止时按 bash 的习惯打印提示
+int child_status(int status)
+{
+    if (WIFSIGNALED(status))
+    {
+        // WTERMSIG 获取终止子进程的信号编号
+        if (WTERMSIG(status) == SIGQUIT)
+        {
+            // 标准 Bash 行为：在 stderr 或 stdout 打印 "Quit"
+            // 注意：\n 之前通常会有个 (core dumped)，取决于系统配置
+            write(1, "Quit (core dumped)\n", 19);
+        }
+        else if (WTERMSIG(status) == SIGINT)
+        {
+            // Ctrl+C 终止时，通常只需要换行
+            write(1, "\n", 1);
+        }
+        return 128 + WTERMSIG(status); // 130 / 131 ...
+    }
+    if (WIFEXITED(status))
+        return WEXITSTATUS(status); // 正常退出，记录退出码
+    return 1;
+}
+
+// 启动一个外部命令，不等待
+// fd_in / fd_out：管道端点，-1 表示继承；命令自己的重定向优先于管道
+// 返回子进程 pid；没能产生子进程（找不到命令、重定向失败）时返回 -1，
+// *status 为应记录的退出码
+pid_t spawn_external(ast *n, t_env *env, t_minishell *minishell,
+    int fd_in, int fd_out, int *status)
+{
+    // 在父进程里取 envp 并查命令路径：两者都有缓存，结果留在父进程供下次复用
+    char **envp = env_envp(env);
+    if (!envp)
+    {
+        perror("malloc");
+        close_heredoc_fds(n->redir);
+        return (*status = 1, -1);
+    }
+    // 重定向也在父进程里打开，子进程只需 dup2，
+    // 这样 fork / vfork / posix_spawn 三种启动方式行为一致
+    t_spawn sp = {n->argv, NULL, envp, -1, -1, minishell->async};
+    int err = open_redirs(n->redir, &sp.fd_in, &sp.fd_out);
+    close_heredoc_fds(n->redir);
+    if (err)
+        return (*status = 1, -1);
+    int rin = sp.fd_in;
+    int rout = sp.fd_out;
+    if (sp.fd_in < 0)
+        sp.fd_in = fd_in;
+    if (sp.fd_out < 0)
+        sp.fd_out = fd_out;
+    pid_t pid = -1;
+    int found = cmd_lookup(minishell, n->argv[0], &sp.path);
+    if (found)
+        *status = exec_error(n->argv[0], found, 0);
+    else
+        pid = spawn_cmd(&sp, spawn_mode(env), status);
+    // 只关自己打开的重定向，管道端点归调用者
+    if (rin >= 0)
+        close(rin);
+    if (rout >= 0)
+        close(rout);
+    return pid;
+}
+
+// 一次性子进程（子 shell、管道里 fork 出来的阶段）执行外部命令：
+// 这个进程之后不再有别的事可做，直接在本进程里 execve，省掉一次 fork。不会返回
+static void exec_in_place(ast *n, t_env *env, t_minishell *minishell)
+{
+    const char *path = NULL;
+    char **envp = env_envp(env);
+    int fd_in;
+    int fd_out;
+    int found;
+
+    if (!envp)
+        exit(1);
+    if (open_redirs(n->redir, &fd_in, &fd_out))
+        exit(1);
+    if ((fd_in >= 0 && dup2(fd_in, STDIN_FILENO) < 0)
+        || (fd_out >= 0 && dup2(fd_out, STDOUT_FILENO) < 0))
+    {
+        perror("dup2");
+        exit(1);
+    }
+    found = cmd_lookup(minishell, n->argv[0], &path);
+    if (found)
+        exit(exec_error(n->argv[0], found, 0));
+    fflush(stdout); // 之前内建命令的输出还在缓冲区里，exec 会把它丢掉
+    execve(path, n->argv, envp);
+    exit(exec_error(n->argv[0], 0, errno));
+}
+
+// 在 shell 进程里执行内建命令：重定向只在执行期间生效，之后恢复标准输入输出
+// 输出一律在结束时 flush：脚本 / 管道里 stdout 是全缓冲的，
+// 不 flush 的话会排到之后外部命令的输出后面，fork 时还会被子进程重复写出
+int run_builtin(ast *n, t_env *env, t_minishell *minishell)
+{
+    if (!n->redir)
+    {
+        int ret = exec_builtin(n, env, minishell);
+        fflush(stdout);
+        return ret;
+    }
+    // 临时保存标准输入输出
+    int stdin_bak = dup(STDIN_FILENO);
+    int stdout_bak = dup(STDOUT_FILENO);
+    int rc = 1;
+    if (apply_redirs(n->redir) == 0)
+        rc = exec_builtin(n, env, minishell);
+    // 先写进重定向的目标，再恢复 fd
+    fflush(stdout);
+    // 恢复标准输入输出
+    dup2(stdin_bak, STDIN_FILENO);
+    dup2(stdout_bak, STDOUT_FILENO);
+    close(stdin_bak);
+    close(stdout_bak);
+    close_heredoc_fds(n->redir);
+    return rc;
+}
+
+// 执行命令节点（spawn 外部命令或内建）
+static int exec_cmd_node(ast *n, t_env *env, t_minishell *minishell)
 {
     if (!n)
         return 1;
+    if (!expand_cmd(minishell, n))
+    {
+        perror("malloc");
+        return 1;
+    }
 
     // 纯重定向，没有命令
     // 纯重定向
@@ -148,80 +276,44 @@ static int exec_cmd_node(ast *n, t_env **env, t_minishell *minishell)
     }
 
     if (is_builtin(n->argv[0]))
-    {
-        if (n->redir)
-        {
-            // 临时保存标准输入输出
-            int stdin_bak = dup(STDIN_FILENO);
-            int stdout_bak = dup(STDOUT_FILENO);
-            if (apply_redirs(n->redir) < 0)
-                return 1;
-            int rc = exec_builtin(n, env);
-            // 恢复标准输入输出
-            dup2(stdin_bak, STDIN_FILENO);
-            dup2(stdout_bak, STDOUT_FILENO);
-            close(stdin_bak);
-            close(stdout_bak);
-            return rc;
-        }
-        else
-            return exec_builtin(n, env);
-    }
+        return run_builtin(n, env, minishell);
 
-    pid_t pid = fork();
+    if (minishell->disposable)
+        exec_in_place(n, env, minishell);
+    int status = 0;
+    pid_t pid = spawn_external(n, env, minishell, -1, -1, &status);
     if (pid < 0)
-    {
-        perror("fork");
-        return 1;
-    }
-
-    if (pid == 0)
-    {
-        setup_child_signals();
-        if (apply_redirs(n->redir))
-            exit(minishell->last_exit_status);
-
-        execvp(n->argv[0], n->argv);
-        perror("execvp");
-        exit(127);
-    }
-    else
-    {
+        return (minishell->last_exit_status = status);
+    t_fg fg;
+    fg_begin(&fg, &pid, 1, minishell);
+    setup_parent_exec_signals();
+    batch_prefetch(minishell); // 子进程运行期间预处理后续输入行
+    minishell->last_exit_status = fg_end(&fg, 1, minishell);
+    return minishell->last_exit_status;
+}
 
-        // parent
-        // parent should close heredoc read fds
-        setup_parent_exec_signals();
-        close_heredoc_fds(n->redir);
-        int status;
-        waitpid(pid, &status, 0);
+// 执行列表节点：a && b、a || b、a ; b。
+// 左边执行完先记下 $?，右边的展开（执行时才做）能看到它。
+// 左边不是最后一条命令，即使在一次性子进程里也不能直接 exec 掉，
+// 执行左边时暂时清掉 disposable。左边被 Ctrl+C 中断时整个列表停止（与 bash 相同）
+static int exec_list(ast *n, t_env *env, t_minishell *minishell)
+{
+    int disposable = minishell->disposable;
+    int status;
 
-        if (WIFSIGNALED(status))
-        {
-            // WTERMSIG 获取终止子进程的信号编号
-            if (WTERMSIG(status) == SIGQUIT)
-            {
-                // 标准 Bash 行为：在 stderr 或 stdout 打印 "Quit"
-                // 注意：\n 之前通常会有个 (core dumped)，取决于系统配置
-                write(1, "Quit (core dumped)\n", 19);
-                minishell->last_exit_status = 131; // 128 + 3
-            }
-            else if (WTERMSIG(status) == SIGINT)
-            {
-                // Ctrl+C 终止时，通常只需要换行
-                write(1, "\n", 1);
-                minishell->last_exit_status = 130; // 128 + 2
-            }
-        }
-        else if (WIFEXITED(status))
-        {
-            // 正常退出，记录退出码
-            minishell->last_exit_status = WEXITSTATUS(status);
-        }
-        return minishell->last_exit_status;
-    }
+    minishell->disposable = 0;
+    status = exec_ast(n->left, env, minishell);
+    minishell->disposable = disposable;
+    minishell->last_exit_status = status;
+    if (status == 128 + SIGINT)
+        return status;
+    if ((n->type == NODE_AND && status != 0)
+        || (n->type == NODE_OR && status == 0))
+        return status;
+    return exec_ast(n->right, env, minishell);
 }
 
-int exec_ast(ast *n, t_env **env, t_minishell *minishell)
+int exec_ast(ast *n, t_env *env, t_minishell *minishell)
 {
     if (!n)
         return 0;
@@ -230,60 +322,21 @@ int exec_ast(ast *n, t_env **env, t_minishell *minishell)
     case NODE_CMD:
         return exec_cmd_node(n, env, minishell);
     case NODE_PIPE:
-    {
-        // 管道：创建 pipe，然后 fork 两个子进程
-        int pipefd[2];
-        if (pipe(pipefd) < 0)
-        {
-            perror("pipe");
-            return 1;
-        }
-        pid_t pid1 = fork();
-        if (pid1 < 0)
-        {
-            perror("fork");
-            return 1;
-        }
-        if (pid1 == 0)
-        {
-            // 左侧命令：输出端写入 pipe
-            close(pipefd[0]);
-            dup2(pipefd[1], STDOUT_FILENO);
-            close(pipefd[1]);
-            int rc = exec_ast(n->left, env, minishell);
-            exit(rc);
-        }
-
-        pid_t pid2 = fork();
-        if (pid2 < 0)
-        {
-            perror("fork");
-            return 1;
-        }
-        if (pid2 == 0)
-        {
-            // 右侧命令：从 pipe 读入
-            close(pipefd[1]);
-            dup2(pipefd[0], STDIN_FILENO);
-            close(pipefd[0]);
-            int rc = exec_ast(n->right, env, minishell);
-            exit(rc);
-        }
-
-        // 父进程：关闭管道端点，等待子进程
-        close(pipefd[0]);
-        close(pipefd[1]);
-        int status1, status2;
-        waitpid(pid1, &status1, 0);
-        waitpid(pid2, &status2, 0);
-        // 这里我们简单返回右侧命令的状态
-        if (WIFEXITED(status2))
-            return WEXITSTATUS(status2);
-        return 1;
-    }
+        return exec_pipeline(n, env, minishell);
+    case NODE_AND:
+    case NODE_OR:
+    case NODE_SEQUENCE:
+        return exec_list(n, env, minishell);
+    case NODE_BACKGROUND:
+        return exec_background(n, env, minishell);
+    case NODE_TIME:
+        return exec_time(n, env, minishell);
     case NODE_SUBSHELL:
     {
-        pid_t pid = fork();
+        // 已经是一次性子进程（如管道里的 (...) 阶段）：它本身就是独立进程，无需再 fork
+        if (minishell->disposable)
+            return exec_ast(n->sub, env, minishell);
+        pid_t pid = shell_fork("subshell");
         if (pid < 0)
         {
             perror("fork for subshell");
@@ -291,16 +344,18 @@ int exec_ast(ast *n, t_env **env, t_minishell *minishell)
         }
         if (pid == 0)
         {
+            // 子 shell 里的命令可能直接 exec，先把信号恢复成默认
+            setup_child_signals();
+            minishell->disposable = 1;
             int rc = exec_ast(n->sub, env, minishell);
             exit(rc);
         }
         else
         {
-            int status = 0;
-            waitpid(pid, &status, 0);
-            if (WIFEXITED(status))
-                return WEXITSTATUS(status);
-            return 1;
+            t_fg fg;
+            fg_begin(&fg, &pid, 1, minishell);
+            setup_parent_exec_signals();
+            return fg_end(&fg, 1, minishell);
         }
     }
     default:
@@ -1,29 +1,177 @@
 #ifndef EXEC_H
 #define EXEC_H
 
-typedef struct s_env {
-    char *key;
-    char *value;
-    struct s_env *next;
-} t_env;
-
-int exec_ast(ast *n, t_env **env, t_minishell *minishell);
-int exec_builtin(ast *node, t_env **env);
+#include <time.h>
+
+#define CMD_CACHE_INIT_SLOTS 32
+// 找不到的命令缓存多久（秒），过期后重新搜索 PATH
+#define CMD_CACHE_NEG_TTL 2
+
+// 命令路径缓存的一项：name → path
+// path 为 NULL 表示负缓存（status 为 127 找不到 / 126 不可执行），
+// 在 expires 之前不再重复搜索 PATH
+typedef struct s_cmd_entry {
+    char *name;
+    char *path;
+    int status;
+    unsigned int hash;
+    unsigned int hits;
+    time_t expires;
+} t_cmd_entry;
+
+// 命令路径缓存（开放寻址，name 为 NULL 的槽是空槽）
+// path_value：建立缓存时的 PATH，PATH 变化后整体清空
+// env_gen：上次核对 PATH 时变量表的代数，没变就不必再比较字符串
+typedef struct s_cmd_cache {
+    t_cmd_entry *slots;
+    int n_slots;
+    int count;
+    char *path_value;
+    unsigned long env_gen;
+} t_cmd_cache;
+
+// 外部命令的启动方式，运行时由变量 MINISHELL_SPAWN 选择（默认 posix_spawn）
+typedef enum e_spawn_mode {
+    SPAWN_FORK,
+    SPAWN_VFORK,
+    SPAWN_POSIX,
+} t_spawn_mode;
+
+// 一次外部命令启动所需的全部内容，在父进程里准备好，三种方式共用
+// fd_in / fd_out：父进程已打开的重定向，-1 表示继承；子进程里 dup2 到 0 / 1
+// bg：后台作业的命令，SIGINT / SIGQUIT 在子进程里保持忽略（与 bash 相同）
+typedef struct s_spawn {
+    char **argv;
+    const char *path;
+    char **envp;
+    int fd_in;
+    int fd_out;
+    int bg;
+} t_spawn;
+
+// 后台作业（cmd &）。一条后台管道是一个作业，各阶段都是 shell 的直接子进程
+// pids：各阶段的 pid，已收割的取负（没能启动的阶段是 -1）；n_live：还没收割的个数
+// status：最后一个阶段的退出码（被信号终止时为 128 + 信号），wstatus：它的原始 wait 状态
+// ru：非 NULL 时按阶段记下 wait4 得到的资源用量（被 time 计时的前台命令）
+// cmd：jobs 显示用的命令文本
+typedef struct s_job {
+    int id;
+    pid_t *pids;
+    int n_pids;
+    int n_live;
+    int status;
+    int wstatus;
+    struct rusage *ru;
+    char *cmd;
+    struct s_job *next;
+} t_job;
+
+// 作业表：按启动顺序排列的链表，作业号取当前最大号 + 1（与 bash 相同）
+// last_pid：最近一个后台作业的 pid（$!），0 表示还没有
+// pruned_pid / pruned_status：非交互模式下 $! 的作业结束后被 jobs_prune 删除时，
+// 记下它的 pid 与退出码，之后的 wait $! 仍能拿到（0 表示没有）
+typedef struct s_jobs {
+    t_job *head;
+    pid_t last_pid;
+    pid_t pruned_pid;
+    int pruned_status;
+} t_jobs;
+
+// jobs_reap 的等待状态：before 是开始等待时已结束的作业数
+typedef struct s_reap {
+    t_jobs *jobs;
+    int before;
+} t_reap;
+
+// 前台命令：各阶段登记为 table 里唯一的临时作业 job，由事件核心收割
+// watched：登记成功；否则 fg_end 退回逐个 waitpid
+typedef struct s_fg {
+    t_jobs table;
+    t_job job;
+    int watched;
+} t_fg;
+
+// time 的一次计时：stages 是被计时的管道各阶段的资源用量（按阶段顺序，
+// 在 shell 进程里执行的阶段全为 0），n_stages 为 0 表示没有启动外部进程
+typedef struct s_timing {
+    struct rusage *stages;
+    int n_stages;
+} t_timing;
+
+// fork 方式启动、等收割时再确认是否 exec 成功的子进程（见 spawn_reaped）
+typedef struct s_pending {
+    pid_t *pids;
+    int n;
+    int cap;
+} t_pending;
+
+// parallel 内建的一次运行
+// tmpl：命令模板（::: 之前的参数）；args：::: 之后的输入，NULL 表示从 in 按行读取
+// slots：同时运行的项数（-j）；run：正在运行的项，复用作业表的结构与收割
+// arena：每项的 argv，启动后立即回收
+// failed：失败的项数；stop：不再分发新项；error：模板有错
+typedef struct s_pool {
+    char **tmpl;
+    char **args;
+    t_reader in;
+    int slots;
+    t_jobs run;
+    t_arena *arena;
+    int failed;
+    int stop;
+    int error;
+} t_pool;
+
+int exec_ast(ast *n, t_env *env, t_minishell *minishell);
+int exec_builtin(ast *node, t_env *env, t_minishell *minishell);
 int is_builtin(const char *cmd);
-int ft_cd(char **argv, t_env **env);
+int ft_cd(char **argv, t_env *env);
 int ft_echo(char **argv);
 int builtin_env(char **argv, t_env *env);
 void    print_env(t_env *env);
-t_env	*env_new(char *key, char *value);
-void	env_add_back(t_env **env, t_env *new_env);
-t_env *init_env(char **envp);
-int builtin_export(char **argv, t_env **env);
-int builtin_unset(char **argv, t_env **env);
-t_env *find_env_var(t_env *env, const char *key);
-void change_envp(t_env *env, char ***envp);
+int builtin_export(char **argv, t_env *env);
+int builtin_unset(char **argv, t_env *env);
 int is_valid_identifier(const char *s);
-void free_env(t_env *env);
 int builtin_exit(char **argv);
+int resolve_command(t_env *env, const char *name, char *buf, size_t size);
+int exec_error(const char *name, int status, int err);
+t_spawn_mode spawn_mode(t_env *env);
+int open_redirs(t_redir *r, int *fd_in, int *fd_out);
+pid_t spawn_cmd(t_spawn *sp, t_spawn_mode mode, int *status);
+pid_t shell_fork(const char *what);
+void spawn_reaped(pid_t pid, int st);
+pid_t spawn_external(ast *n, t_env *env, t_minishell *minishell,
+    int fd_in, int fd_out, int *status);
+int child_status(int status);
+void close_heredoc_fds(t_redir *r);
+int exec_pipeline(ast *n, t_env *env, t_minishell *minishell);
+int run_builtin(ast *n, t_env *env, t_minishell *minishell);
+int cmd_lookup(t_minishell *minishell, const char *name, const char **path);
+t_cmd_entry *cmd_cache_add(t_minishell *minishell, const char *name);
+void cmd_cache_clear(t_cmd_cache *cache);
+void cmd_cache_sync(t_minishell *minishell);
+int builtin_hash(char **argv, t_minishell *minishell);
 int builtin_pwd();
+int exec_background(ast *n, t_env *env, t_minishell *minishell);
+pid_t *start_async(ast *n, t_env *env, t_minishell *minishell,
+    int *count, int *status);
+int start_pipeline_bg(ast *n, t_env *env, t_minishell *minishell,
+    int fd_in, pid_t **pids, int *status);
+char *job_text(ast *n);
+t_job *job_add(t_jobs *jobs, pid_t *pids, int n_pids, char *cmd);
+int job_done(t_jobs *jobs, pid_t pid, int st, const struct rusage *ru);
+int jobs_reap(t_jobs *jobs, int block);
+void fg_begin(t_fg *fg, pid_t *pids, int n, t_minishell *minishell);
+int fg_end(t_fg *fg, int last_status, t_minishell *minishell);
+ast **flatten_pipeline(ast *n, int *count, t_arena *arena);
+int exec_time(ast *n, t_env *env, t_minishell *minishell);
+void jobs_notify(t_jobs *jobs, int all);
+void jobs_prune(t_jobs *jobs);
+void job_remove(t_jobs *jobs, t_job *job);
+void jobs_free(t_jobs *jobs);
+int builtin_wait(char **argv, t_minishell *minishell);
+int builtin_jobs(char **argv, t_minishell *minishell);
+int builtin_parallel(char **argv, t_minishell *minishell);
+int builtin_stats(char **argv);
 
 #endif
\ No newline at end of file
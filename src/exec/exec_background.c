@@ -0,0 +1,112 @@
+#include "../../include/minishell.h"
+
+// 交互模式（从终端读命令）：启动后台作业时报告 [作业号] pid
+static int is_interactive(t_minishell *minishell)
+{
+    return (minishell->in && minishell->in->fd >= 0 && !minishell->batch
+        && !minishell->disposable && isatty(STDIN_FILENO));
+}
+
+// 不能直接 spawn 的不等待命令（内建、子 shell、列表、找不到的命令）：
+// fork 一份 shell 执行后退出。子进程是一次性的，最后的外部命令直接 exec。
+// 只有后台作业（minishell->async）忽略 SIGINT / SIGQUIT；
+// parallel 的各项是前台进程，Ctrl+C 照常终止它们
+static pid_t fork_async(ast *n, t_env *env, t_minishell *minishell,
+    int null_in)
+{
+    pid_t pid = shell_fork(minishell->async ? "background" : "parallel");
+
+    if (pid < 0)
+        perror("fork");
+    else if (pid == 0)
+    {
+        setup_child_signals();
+        if (minishell->async)
+        {
+            signal(SIGINT, SIG_IGN);
+            signal(SIGQUIT, SIG_IGN);
+        }
+        if (null_in >= 0 && dup2(null_in, STDIN_FILENO) < 0)
+            exit(1);
+        minishell->disposable = 1;
+        exit(exec_ast(n, env, minishell));
+    }
+    if (null_in >= 0)
+        close(null_in);
+    return pid;
+}
+
+// 启动一个不等待的作业（后台作业、parallel 的一项）的各个进程，
+// 返回 pid 数组（新分配）与个数；
+// 没能启动的阶段 pid 为 -1，*status 为应记录的退出码。
+// 找不到的外部命令也 fork 一份去报错退出（127），与 bash 一样有 pid，wait $! 能拿到退出码
+pid_t *start_async(ast *n, t_env *env, t_minishell *minishell,
+    int *count, int *status)
+{
+    // 没有作业控制时后台命令的标准输入是 /dev/null（与 bash 相同），
+    // 命令自己的输入重定向优先
+    int null_in = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    const char *path;
+    pid_t *pids;
+
+    *count = 0;
+    *status = 0;
+    if (n->type == NODE_PIPE)
+    {
+        *count = start_pipeline_bg(n, env, minishell, null_in, &pids, status);
+        return pids;
+    }
+    pids = malloc(sizeof(pid_t));
+    if (!pids)
+    {
+        if (null_in >= 0)
+            close(null_in);
+        return NULL;
+    }
+    *count = 1;
+    if (n->type == NODE_CMD && !expand_cmd(minishell, n))
+        pids[0] = (*status = 1, -1);
+    else if (n->type == NODE_CMD && n->argv && !is_builtin(n->argv[0])
+        && cmd_lookup(minishell, n->argv[0], &path) == 0)
+    {
+        pids[0] = spawn_external(n, env, minishell, null_in, -1, status);
+        if (null_in >= 0)
+            close(null_in);
+    }
+    else
+        pids[0] = fork_async(n, env, minishell, null_in);
+    return pids;
+}
+
+/**
+ * exec_background
+ * ----------------
+ * 目的：
+ *   执行 cmd &：启动后不等待，登记到作业表，立即返回 0。
+ *   后台管道的各阶段仍是 shell 的直接子进程，作业表记录全部 pid；
+ *   结束的进程由事件核心（ev_reap）收割、记到作业表上。
+ *   后台进程忽略 SIGINT / SIGQUIT，终端上的 Ctrl+C 只打断前台命令。
+ */
+int exec_background(ast *n, t_env *env, t_minishell *minishell)
+{
+    ast *sub = n->left;
+    int async = minishell->async;
+    pid_t *pids;
+    t_job *job;
+    int count;
+    int status;
+
+    minishell->async = 1;
+    pids = start_async(sub, env, minishell, &count, &status);
+    minishell->async = async;
+    if (!pids)
+        return (perror("minishell"), 1);
+    job = job_add(&minishell->jobs, pids, count, job_text(sub));
+    if (!job)
+        return (perror("malloc"), 1);
+    if (pids[count - 1] < 0)
+        job->status = status;
+    if (is_interactive(minishell))
+        fprintf(stderr, "[%d] %d\n", job->id, (int)minishell->jobs.last_pid);
+    return 0;
+}
@@ -0,0 +1,157 @@
+#include "../../include/minishell.h"
+
+// 释放缓存中的所有项（hash -r、PATH 变化、退出时）
+void cmd_cache_clear(t_cmd_cache *cache)
+{
+    int i;
+
+    i = 0;
+    while (i < cache->n_slots)
+    {
+        free(cache->slots[i].name);
+        free(cache->slots[i].path);
+        i++;
+    }
+    free(cache->slots);
+    free(cache->path_value);
+    cache->slots = NULL;
+    cache->n_slots = 0;
+    cache->count = 0;
+    cache->path_value = NULL;
+}
+
+// PATH 变了就整体清空：缓存的路径都是按旧 PATH 搜出来的
+// 变量表代数没变时 PATH 不可能变，直接跳过字符串比较
+void cmd_cache_sync(t_minishell *msh)
+{
+    t_cmd_cache *c = &msh->cmds;
+    const char *path;
+
+    if (c->path_value && c->env_gen == msh->env->gen)
+        return;
+    path = env_get(msh->env, "PATH");
+    if (!path)
+        path = "";
+    if (!c->path_value || strcmp(path, c->path_value) != 0)
+    {
+        cmd_cache_clear(c);
+        c->path_value = strdup(path);
+    }
+    c->env_gen = msh->env->gen;
+}
+
+// 线性探测：返回 name 所在的槽，或者它应该插入的空槽
+static t_cmd_entry *cache_slot(t_cmd_cache *c, const char *name, unsigned int h)
+{
+    int mask = c->n_slots - 1;
+    int s = h & mask;
+
+    while (c->slots[s].name
+        && (c->slots[s].hash != h || strcmp(c->slots[s].name, name) != 0))
+        s = (s + 1) & mask;
+    return &c->slots[s];
+}
+
+// 负载超过 1/2 时槽数翻倍并重新插入
+static int cache_grow(t_cmd_cache *c)
+{
+    t_cmd_cache old = *c;
+    int i;
+
+    if (c->slots && (c->count + 1) * 2 <= c->n_slots)
+        return 1;
+    c->n_slots = old.n_slots ? old.n_slots * 2 : CMD_CACHE_INIT_SLOTS;
+    c->slots = ft_calloc(c->n_slots, sizeof(t_cmd_entry));
+    if (!c->slots)
+    {
+        *c = old;
+        return 0;
+    }
+    i = 0;
+    while (i < old.n_slots)
+    {
+        if (old.slots[i].name)
+            *cache_slot(c, old.slots[i].name, old.slots[i].hash) = old.slots[i];
+        i++;
+    }
+    free(old.slots);
+    return 1;
+}
+
+// 搜索 PATH 并把结果（找到的路径或“找不到”）写进缓存，返回该项
+// 已有同名项时原地更新；内存失败返回 NULL
+t_cmd_entry *cmd_cache_add(t_minishell *msh, const char *name)
+{
+    t_cmd_cache *c = &msh->cmds;
+    t_cmd_entry *e;
+    unsigned int h = env_hash(name, strlen(name));
+    char buf[PATH_MAX];
+
+    cmd_cache_sync(msh);
+    if (!cache_grow(c))
+        return NULL;
+    e = cache_slot(c, name, h);
+    if (!e->name)
+    {
+        e->name = strdup(name);
+        if (!e->name)
+            return NULL;
+        e->hash = h;
+        e->hits = 0;
+        c->count++;
+    }
+    free(e->path);
+    e->path = NULL;
+    e->status = resolve_command(msh->env, name, buf, sizeof(buf));
+    if (e->status == 0)
+    {
+        e->path = strdup(buf);
+        if (!e->path)
+            e->status = 127;
+    }
+    e->expires = 0;
+    if (e->status != 0)
+        e->expires = time(NULL) + CMD_CACHE_NEG_TTL;
+    return e;
+}
+
+// 查找要执行的命令（在父进程 fork 之前调用）
+// 带 '/' 的名字不查 PATH，原样使用
+// 命中缓存：access 确认文件还在（一次系统调用），否则重新搜索
+// 负缓存在过期前直接返回 127 / 126，不再逐个目录试探
+// 返回 0 并设置 *path，或 126 / 127
+int cmd_lookup(t_minishell *msh, const char *name, const char **path)
+{
+    static char fallback[PATH_MAX];
+    t_cmd_cache *c = &msh->cmds;
+    t_cmd_entry *e = NULL;
+    int st;
+
+    *path = name;
+    if (strchr(name, '/'))
+        return 0;
+    if (!*name)
+        return 127;
+    cmd_cache_sync(msh);
+    if (c->slots)
+        e = cache_slot(c, name, env_hash(name, strlen(name)));
+    if (e && e->name && e->path && access(e->path, X_OK) == 0)
+    {
+        e->hits++;
+        *path = e->path;
+        return 0;
+    }
+    if (e && e->name && !e->path && time(NULL) < e->expires)
+        return e->status;
+    e = cmd_cache_add(msh, name);
+    if (!e) // 内存不足：不缓存，直接搜索
+    {
+        st = resolve_command(msh->env, name, fallback, sizeof(fallback));
+        *path = fallback;
+        return st;
+    }
+    if (e->path)
+        e->hits++;
+    *path = e->path;
+    return e->status;
+}
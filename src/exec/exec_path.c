@@ -0,0 +1,73 @@
+#include "../../include/minishell.h"
+#include <sys/stat.h>
+#include <errno.h>
+
+// PATH 没有设置时使用的默认搜索路径（与 execvp 相同）
+#define DEFAULT_PATH "/bin:/usr/bin"
+
+// 是否是可执行的普通文件（目录即使有 x 权限也不行）
+static int is_exec_file(const char *path)
+{
+    struct stat st;
+
+    if (stat(path, &st) != 0 || S_ISDIR(st.st_mode))
+        return 0;
+    return (access(path, X_OK) == 0);
+}
+
+// 在 shell 自己的 PATH（变量表，而不是进程的 environ）里查找 name
+// 找到：完整路径写入 buf，返回 0
+// 找不到：返回 127；存在但不可执行：返回 126
+int resolve_command(t_env *env, const char *name, char *buf, size_t size)
+{
+    const char *path = env_get(env, "PATH");
+    const char *dir;
+    const char *end;
+    size_t dlen;
+    size_t nlen = strlen(name);
+    int ret = 127;
+
+    if (!path)
+        path = DEFAULT_PATH;
+    dir = path;
+    while (*name && dir)
+    {
+        end = strchr(dir, ':');
+        dlen = end ? (size_t)(end - dir) : strlen(dir);
+        if (dlen + nlen + 2 <= size)
+        {
+            if (dlen == 0) // 空目录项表示当前目录
+            {
+                buf[0] = '.';
+                dlen = 1;
+            }
+            else
+                memcpy(buf, dir, dlen);
+            buf[dlen] = '/';
+            memcpy(buf + dlen + 1, name, nlen + 1);
+            if (is_exec_file(buf))
+                return 0;
+            if (access(buf, F_OK) == 0)
+                ret = 126;
+        }
+        dir = end ? end + 1 : NULL;
+    }
+    return ret;
+}
+
+// 报告外部命令无法执行的原因，返回应记录的退出码
+// status 为 cmd_lookup 的结果（127 找不到 / 126 不可执行）；
+// err 非 0 时是 execve / posix_spawn 失败的 errno
+int exec_error(const char *name, int status, int err)
+{
+    if (err)
+    {
+        fprintf(stderr, "%s: %s\n", name, strerror(err));
+        return (err == ENOENT ? 127 : 126);
+    }
+    if (status == 127)
+        fprintf(stderr, "%s: command not found\n", name);
+    else
+        fprintf(stderr, "%s: Permission denied\n", name);
+    return status;
+}
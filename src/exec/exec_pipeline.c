@@ -0,0 +1,247 @@
+#include "../../include/minishell.h"
+
+// parse_pipeline 建出的是左深树：a | b | c | d → ((a | b) | c) | d，
+// 根节点上记着 n_pipes。沿 left 往下走一遍，从右往左填进阶段数组
+ast **flatten_pipeline(ast *n, int *count, t_arena *arena)
+{
+    ast **stages;
+    ast *p;
+    int k;
+
+    k = 1;
+    p = n;
+    while (p->type == NODE_PIPE)
+    {
+        p = p->left;
+        k++;
+    }
+    if (n->n_pipes + 1 != k) // n_pipes 只记在最外层的根上，对不上就以实际深度为准
+        n->n_pipes = k - 1;
+    stages = arena_alloc(arena, sizeof(ast *) * k);
+    if (!stages)
+        return NULL;
+    *count = k;
+    p = n;
+    while (p->type == NODE_PIPE)
+    {
+        stages[--k] = p->right;
+        p = p->left;
+    }
+    stages[0] = p;
+    return stages;
+}
+
+// 新建一条管道，两端都设 close-on-exec：
+// 被 exec 的子进程只保留 dup2 到 0 / 1 的那一份
+static int open_pipe(int fds[2])
+{
+    if (pipe(fds) < 0)
+    {
+        perror("pipe");
+        return 0;
+    }
+    stats_add(STC_PIPES, 1);
+    fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return 1;
+}
+
+// 启动一个阶段，不等待。外部命令直接 spawn，是 shell 的直接子进程；
+// 内建和子 shell 需要 shell 自身来跑，fork 一份执行后退出，
+// 这份拷贝是一次性的：子 shell 里最后的外部命令直接 exec，不再多 fork 一层。
+// spare：本阶段用不到、但子进程会继承的下一条管道读端，fork 后关掉
+static pid_t start_stage(ast *stage, t_env *env, t_minishell *minishell,
+    int fd[2], int spare, int *status)
+{
+    pid_t pid;
+
+    if (stage->type == NODE_CMD && stage->argv && !is_builtin(stage->argv[0]))
+        return spawn_external(stage, env, minishell, fd[0], fd[1], status);
+    pid = shell_fork(stage->argv ? stage->argv[0] : "subshell");
+    if (pid < 0)
+    {
+        perror("fork");
+        *status = 1;
+    }
+    else if (pid == 0)
+    {
+        setup_child_signals();
+        if (minishell->async) // 后台管道的阶段：与外部命令一样忽略 SIGINT / SIGQUIT
+        {
+            signal(SIGINT, SIG_IGN);
+            signal(SIGQUIT, SIG_IGN);
+        }
+        if (spare >= 0)
+            close(spare);
+        if (fd[0] >= 0 && (dup2(fd[0], STDIN_FILENO) < 0 || close(fd[0])))
+            exit(1);
+        if (fd[1] >= 0 && (dup2(fd[1], STDOUT_FILENO) < 0 || close(fd[1])))
+            exit(1);
+        minishell->disposable = 1;
+        exit(exec_ast(stage, env, minishell));
+    }
+    if (stage->type == NODE_CMD)
+        close_heredoc_fds(stage->redir);
+    return pid;
+}
+
+// lastpipe：打开了 lastpipe（启动时设置了 MINISHELL_LASTPIPE）且最后一个阶段
+// 是内建命令时，它在 shell 进程里执行（与 bash 的 shopt -s lastpipe 相同），
+// 省掉一次 fork，export / cd / exit 等也能作用于 shell 本身
+static int is_lastpipe(ast *stage, t_minishell *minishell)
+{
+    return (minishell->lastpipe && stage->type == NODE_CMD && stage->argv
+        && is_builtin(stage->argv[0]));
+}
+
+// 在 shell 进程里执行最后的内建阶段：标准输入临时换成管道读端，
+// 结束后恢复（内建自己的重定向由 run_builtin 处理）。fd_in 在这里关闭
+static int run_last_builtin(ast *stage, t_env *env, t_minishell *minishell,
+    int fd_in)
+{
+    int stdin_bak;
+    int rc;
+
+    stdin_bak = dup(STDIN_FILENO);
+    if (stdin_bak < 0 || dup2(fd_in, STDIN_FILENO) < 0)
+    {
+        perror("dup2");
+        close(fd_in);
+        if (stdin_bak >= 0)
+            close(stdin_bak);
+        return 1;
+    }
+    close(fd_in);
+    rc = run_builtin(stage, env, minishell);
+    dup2(stdin_bak, STDIN_FILENO);
+    close(stdin_bak);
+    return rc;
+}
+
+// 展开各阶段（启动前完成：外部命令由父进程直接 spawn，
+// 是否内建也要按展开后的命令名判断），返回阶段数组
+static ast **prepare_stages(ast *n, int *count, t_minishell *minishell)
+{
+    ast **stages;
+    int i;
+
+    stages = flatten_pipeline(n, count, minishell->arena);
+    if (!stages)
+        return NULL;
+    i = 0;
+    while (i < *count)
+    {
+        if (stages[i]->type == NODE_CMD && !expand_cmd(minishell, stages[i]))
+            return NULL;
+        i++;
+    }
+    return stages;
+}
+
+// 依次启动 stages[0 .. n)，count 是整条管道的阶段数（最后一个阶段不建管道）。
+// 管道逐级创建：启动第 i 个阶段时父进程只持有上一条管道的读端和当前管道。
+// *prev_in 进来时是第一个阶段的输入（-1 表示继承，否则归本函数关闭），
+// 出去时是最后一条管道的读端。返回启动了几个阶段（建管道失败时少于 n）
+static int start_stages(ast **stages, int n, int count, t_env *env,
+    t_minishell *minishell, pid_t *pids, int *prev_in, int *status)
+{
+    int pfd[2];
+    int fd[2];
+    int i;
+
+    i = 0;
+    while (i < n)
+    {
+        pfd[0] = -1;
+        pfd[1] = -1;
+        if (i < count - 1 && !open_pipe(pfd))
+            break;
+        fd[0] = *prev_in;
+        fd[1] = pfd[1];
+        pids[i] = start_stage(stages[i], env, minishell, fd, pfd[0], status);
+        if (*prev_in >= 0)
+            close(*prev_in);
+        if (pfd[1] >= 0)
+            close(pfd[1]);
+        *prev_in = pfd[0];
+        i++;
+    }
+    return i;
+}
+
+// 执行整条管道：所有阶段都是 shell 的直接子进程，N 个阶段 N 次进程创建，
+// 上千个阶段也不会耗尽 fd
+int exec_pipeline(ast *n, t_env *env, t_minishell *minishell)
+{
+    ast **stages;
+    pid_t *pids;
+    t_fg fg;
+    int count;
+    int status;
+    int prev_in;
+    int n_fork;
+    int i;
+
+    stages = prepare_stages(n, &count, minishell);
+    pids = NULL;
+    if (stages)
+        pids = arena_alloc(minishell->arena, sizeof(pid_t) * count);
+    if (!pids)
+        return (perror("malloc"), 1);
+    n_fork = count;
+    if (is_lastpipe(stages[count - 1], minishell))
+        n_fork = count - 1;
+    prev_in = -1;
+    status = 0;
+    i = start_stages(stages, n_fork, count, env, minishell, pids, &prev_in,
+        &status);
+    fg_begin(&fg, pids, i, minishell); // 在内建阶段运行之前登记，它可能收割子进程
+    setup_parent_exec_signals();
+    if (i == n_fork && n_fork < count)
+    {
+        status = run_last_builtin(stages[count - 1], env, minishell, prev_in);
+        fg_end(&fg, status, minishell);
+        return status;
+    }
+    if (prev_in >= 0)
+        close(prev_in);
+    batch_prefetch(minishell);
+    if (i < count) // 建管道失败：已启动的阶段照常收割，整条管道算失败
+        return (fg_end(&fg, 1, minishell), 1);
+    return fg_end(&fg, status, minishell);
+}
+
+// 把整条管道作为后台作业启动，不等待。fd_in 是第一个阶段的输入（归本函数关闭）。
+// 各阶段的 pid 写进新分配的 *pids（调用者负责释放，收进作业表），
+// 没能启动的阶段是 -1，*status 为它应记录的退出码。
+// 返回启动了几个阶段；一个都没启动时返回 0，*pids 为 NULL
+int start_pipeline_bg(ast *n, t_env *env, t_minishell *minishell,
+    int fd_in, pid_t **pids, int *status)
+{
+    ast **stages;
+    int count;
+    int i;
+
+    *pids = NULL;
+    stages = prepare_stages(n, &count, minishell);
+    if (stages)
+        *pids = malloc(sizeof(pid_t) * count);
+    if (!*pids)
+    {
+        perror("malloc");
+        if (fd_in >= 0)
+            close(fd_in);
+        return 0;
+    }
+    *status = 0;
+    i = start_stages(stages, count, count, env, minishell, *pids, &fd_in,
+        status);
+    if (fd_in >= 0)
+        close(fd_in);
+    if (i == 0)
+    {
+        free(*pids);
+        *pids = NULL;
+    }
+    return i;
+}
@@ -0,0 +1,269 @@
+#include "../../include/minishell.h"
+#include <spawn.h>
+#include <errno.h>
+
+// 按 shell 变量 MINISHELL_SPAWN 选择启动方式（fork / vfork / posix_spawn），
+// 每条命令都重新读取，export 之后立即生效，方便在同一台机器上对比三者
+t_spawn_mode spawn_mode(t_env *env)
+{
+    const char *v = env_get(env, "MINISHELL_SPAWN");
+
+    if (v && strcmp(v, "fork") == 0)
+        return SPAWN_FORK;
+    if (v && strcmp(v, "vfork") == 0)
+        return SPAWN_VFORK;
+    return SPAWN_POSIX;
+}
+
+// 换上新打开的 fd，旧的（上一个同方向的重定向）关掉
+static void replace_fd(int *slot, int fd)
+{
+    if (*slot >= 0)
+        close(*slot);
+    *slot = fd;
+}
+
+// 在父进程里按顺序打开所有重定向，最后生效的输入/输出留在 fd_in/fd_out
+// （-1 表示不重定向）。heredoc 的读端转交给调用者，r->heredoc_fd 置 -1。
+// 这样子进程里只剩 dup2，三种启动方式都能表达；出错时报错并返回 1
+int open_redirs(t_redir *r, int *fd_in, int *fd_out)
+{
+    int fd;
+
+    *fd_in = -1;
+    *fd_out = -1;
+    while (r)
+    {
+        fd = -1;
+        if (r->type == REDIR_INPUT)
+            fd = open(r->filename, O_RDONLY | O_CLOEXEC);
+        else if (r->type == REDIR_OUTPUT)
+            fd = open(r->filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        else if (r->type == REDIR_APPEND)
+            fd = open(r->filename, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        else if (r->type == HEREDOC)
+        {
+            fd = r->heredoc_fd;
+            r->heredoc_fd = -1;
+        }
+        if (fd < 0)
+        {
+            if (r->type != HEREDOC)
+                perror(r->filename);
+            replace_fd(fd_in, -1);
+            replace_fd(fd_out, -1);
+            return 1;
+        }
+        if (r->type == REDIR_INPUT || r->type == HEREDOC)
+            replace_fd(fd_in, fd);
+        else
+            replace_fd(fd_out, fd);
+        r = r->next;
+    }
+    return 0;
+}
+
+// 子进程一侧（fork / vfork 共用）：只做 dup2、恢复信号和 execve，
+// 全部是 async-signal-safe 的调用，vfork 时也不会弄乱父进程的内存。
+// 只在失败时返回，返回值是 errno，由调用者决定在哪里报错
+static int child_exec(t_spawn *sp, sigset_t *mask)
+{
+    if ((sp->fd_in >= 0 && dup2(sp->fd_in, STDIN_FILENO) < 0)
+        || (sp->fd_out >= 0 && dup2(sp->fd_out, STDOUT_FILENO) < 0))
+        return errno;
+    if (!sp->bg)
+    {
+        signal(SIGINT, SIG_DFL);
+        signal(SIGQUIT, SIG_DFL);
+    }
+    signal(SIGTSTP, SIG_DFL);
+    sigprocmask(SIG_SETMASK, mask, NULL);
+    execve(sp->path, sp->argv, sp->envp);
+    return errno;
+}
+
+// fork：子进程有独立的内存，自己报错退出
+static pid_t spawn_fork(t_spawn *sp, sigset_t *mask)
+{
+    pid_t pid = fork();
+
+    if (pid == 0)
+        _exit(exec_error(sp->argv[0], 0, child_exec(sp, mask)));
+    return pid;
+}
+
+// fork 方式启动、还不知道 exec 是否成功的子进程
+static t_pending *pending(void)
+{
+    static t_pending p;
+
+    return &p;
+}
+
+// 记下一个 fork 方式的子进程，收割时再决定算不算 exec（内存不足时不记，也就不算）
+static void pending_add(pid_t pid)
+{
+    t_pending *p = pending();
+    pid_t *grown;
+
+    if (p->n == p->cap)
+    {
+        grown = realloc(p->pids, sizeof(pid_t) * (p->cap ? p->cap * 2 : 16));
+        if (!grown)
+            return;
+        p->pids = grown;
+        p->cap = p->cap ? p->cap * 2 : 16;
+    }
+    p->pids[p->n++] = pid;
+}
+
+// 子进程被收割（事件核心或 fg_end）时调用：fork 方式启动的子进程
+// 退出码不是 exec 失败的 126 / 127 时才算一次 exec。
+// 不在启动路径上加系统调用；代价是 exec 成功后自己以 126 / 127 退出的命令不计入
+void spawn_reaped(pid_t pid, int st)
+{
+    t_pending *p = pending();
+
+    for (int i = 0; i < p->n; i++)
+    {
+        if (p->pids[i] != pid)
+            continue;
+        p->pids[i] = p->pids[--p->n];
+        if (!WIFEXITED(st) || (WEXITSTATUS(st) != 126 && WEXITSTATUS(st) != 127))
+            stats_add(STC_EXECS, 1);
+        return;
+    }
+}
+
+// vfork：子进程与父进程共享内存，失败时把 errno 写进 err 后 _exit，
+// 父进程醒来后据此报错（子进程里不能碰 stdio）。进入前已屏蔽所有信号，
+// 避免子进程在恢复默认处理之前跑到 shell 的信号处理函数里
+static pid_t spawn_vfork(t_spawn *sp, sigset_t *mask, int *status)
+{
+    volatile int err = 0;
+    pid_t pid = vfork();
+
+    if (pid == 0)
+    {
+        err = child_exec(sp, mask);
+        _exit(err == ENOENT ? 127 : 126);
+    }
+    if (pid > 0 && err)
+        *status = exec_error(sp->argv[0], 0, err);
+    return pid;
+}
+
+// posix_spawn：重定向变成 dup2 file action，信号复位用 SETSIGDEF
+// （后台命令不复位 SIGINT / SIGQUIT，继承 spawn_cmd 设好的忽略），
+// 信号屏蔽字用 SETSIGMASK。exec 失败时 posix_spawn 直接返回错误码，不留子进程
+static pid_t spawn_posix(t_spawn *sp, sigset_t *mask, int *status)
+{
+    posix_spawn_file_actions_t fa;
+    posix_spawnattr_t attr;
+    sigset_t def;
+    pid_t pid = -1;
+    int err;
+
+    posix_spawn_file_actions_init(&fa);
+    posix_spawnattr_init(&attr);
+    if (sp->fd_in >= 0)
+        posix_spawn_file_actions_adddup2(&fa, sp->fd_in, STDIN_FILENO);
+    if (sp->fd_out >= 0)
+        posix_spawn_file_actions_adddup2(&fa, sp->fd_out, STDOUT_FILENO);
+    sigemptyset(&def);
+    if (!sp->bg)
+    {
+        sigaddset(&def, SIGINT);
+        sigaddset(&def, SIGQUIT);
+    }
+    sigaddset(&def, SIGTSTP);
+    posix_spawnattr_setsigdefault(&attr, &def);
+    posix_spawnattr_setsigmask(&attr, mask);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK);
+    err = posix_spawn(&pid, sp->path, &fa, &attr, sp->argv, sp->envp);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&fa);
+    if (err)
+    {
+        *status = exec_error(sp->argv[0], 0, err);
+        return -1;
+    }
+    return pid;
+}
+
+// 按 mode 启动外部命令，sp->fd_in / fd_out 由调用者在之后关闭
+// 后台命令（sp->bg）：启动期间 shell 自己临时忽略 SIGINT / SIGQUIT，
+// 子进程继承忽略，exec 之后也保持（被捕获的信号 exec 时会复位成默认）
+// 返回子进程 pid；没能产生子进程时返回 -1，*status 为应记录的退出码
+pid_t spawn_cmd(t_spawn *sp, t_spawn_mode mode, int *status)
+{
+    struct sigaction ign;
+    struct sigaction old_int;
+    struct sigaction old_quit;
+    sigset_t all;
+    sigset_t old;
+    uint64_t t;
+    pid_t pid;
+
+    *status = 0;
+    t = stats_now();
+    sigfillset(&all);
+    sigprocmask(SIG_BLOCK, &all, &old);
+    if (sp->bg)
+    {
+        ft_bzero(&ign, sizeof(ign));
+        ign.sa_handler = SIG_IGN;
+        sigaction(SIGINT, &ign, &old_int);
+        sigaction(SIGQUIT, &ign, &old_quit);
+    }
+    if (mode == SPAWN_VFORK)
+        pid = spawn_vfork(sp, &old, status);
+    else if (mode == SPAWN_POSIX)
+        pid = spawn_posix(sp, &old, status);
+    else
+        pid = spawn_fork(sp, &old);
+    if (sp->bg)
+    {
+        sigaction(SIGINT, &old_int, NULL);
+        sigaction(SIGQUIT, &old_quit, NULL);
+    }
+    sigprocmask(SIG_SETMASK, &old, NULL);
+    if (pid < 0 && !*status)
+    {
+        perror("fork");
+        *status = 1;
+    }
+    stats_time(STH_SPAWN, t);
+    if (pid > 0)
+        stats_add(STC_FORKS, 1);
+    // 只算真正 exec 成功的：vfork / posix_spawn 返回时已经知道结果，
+    // fork 方式要等收割时看退出码（见 spawn_reaped）
+    if (pid > 0 && mode == SPAWN_FORK)
+        pending_add(pid);
+    else if (pid > 0 && !*status)
+        stats_add(STC_EXECS, 1);
+    trace_span("spawn", t, "pid", pid);
+    trace_child('B', sp->argv[0], pid, NULL, 0);
+    // vfork / posix_spawn 返回时子进程已经 exec；fork 方式不知道何时 exec
+    if (pid > 0 && mode != SPAWN_FORK && !*status)
+        trace_child('i', "exec", pid, NULL, 0);
+    return pid;
+}
+
+// fork 一份 shell（子 shell、不能直接 spawn 的管道阶段与后台作业）。
+// 跟踪时记一段 fork，并为子进程开一条轨道，what 是轨道上显示的名字
+pid_t shell_fork(const char *what)
+{
+    uint64_t t = trace_now();
+    pid_t pid = fork();
+
+    if (pid > 0)
+    {
+        stats_add(STC_FORKS, 1);
+        trace_span("fork", t, "pid", pid);
+        trace_child('B', what, pid, NULL, 0);
+    }
+    else if (pid == 0)
+        trace_forked();
+    return pid;
+}
@@ -0,0 +1,201 @@
+#include "../../include/minishell.h"
+
+// 没有设置 TIMEFORMAT 时的格式：bash 的默认格式，再加上最大常驻内存与上下文切换
+#define TIME_DEFAULT_FMT "\nreal\t%3lR\nuser\t%3lU\nsys\t%3lS" \
+    "\nmaxrss\t%MK\nctxsw\t%w voluntary, %c involuntary"
+// time -p：POSIX 规定的格式，不看 TIMEFORMAT
+#define TIME_POSIX_FMT "real %2R\nuser %2U\nsys %2S"
+
+static double tv_secs(struct timeval tv)
+{
+    return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// 把 b 的用量累加到 a：时间与切换次数求和，最大常驻内存取最大值
+static void ru_add(struct rusage *a, const struct rusage *b)
+{
+    a->ru_utime.tv_sec += b->ru_utime.tv_sec;
+    a->ru_utime.tv_usec += b->ru_utime.tv_usec;
+    a->ru_stime.tv_sec += b->ru_stime.tv_sec;
+    a->ru_stime.tv_usec += b->ru_stime.tv_usec;
+    if (b->ru_maxrss > a->ru_maxrss)
+        a->ru_maxrss = b->ru_maxrss;
+    a->ru_nvcsw += b->ru_nvcsw;
+    a->ru_nivcsw += b->ru_nivcsw;
+}
+
+// shell 进程自己在计时期间的用量（解析、内建命令、lastpipe 的内建阶段）：
+// 时间与切换次数取差值；最大常驻内存是整个进程的峰值，不计入
+static void ru_add_self(struct rusage *a, const struct rusage *before,
+    const struct rusage *after)
+{
+    struct rusage d;
+
+    ft_bzero(&d, sizeof(d));
+    d.ru_utime.tv_sec = after->ru_utime.tv_sec - before->ru_utime.tv_sec;
+    d.ru_utime.tv_usec = after->ru_utime.tv_usec - before->ru_utime.tv_usec;
+    d.ru_stime.tv_sec = after->ru_stime.tv_sec - before->ru_stime.tv_sec;
+    d.ru_stime.tv_usec = after->ru_stime.tv_usec - before->ru_stime.tv_usec;
+    d.ru_nvcsw = after->ru_nvcsw - before->ru_nvcsw;
+    d.ru_nivcsw = after->ru_nivcsw - before->ru_nivcsw;
+    ru_add(a, &d);
+}
+
+// 按 TIMEFORMAT 的写法输出秒数：prec 位小数；lng 时写成 1m2.345s
+static int put_secs(t_strbuf *sb, double secs, int prec, int lng)
+{
+    char buf[64];
+    int n;
+
+    if (lng)
+        n = snprintf(buf, sizeof(buf), "%dm%.*fs", (int)(secs / 60), prec,
+            secs - 60 * (int)(secs / 60));
+    else
+        n = snprintf(buf, sizeof(buf), "%.*f", prec, secs);
+    return sb_append_span(sb, buf, n);
+}
+
+/**
+ * format_time
+ * ----------------
+ * 目的：
+ *   按 TIMEFORMAT 生成 time 的报告。支持 bash 的写法：
+ *     %%            一个 %
+ *     %[p][l]R      实际经过的时间；p 是小数位数（0 - 3，默认 3），l 写成 XmY.YYYs
+ *     %[p][l]U / S  用户态 / 内核态 CPU 时间
+ *     %P            CPU 占用百分比：(U + S) / R
+ *   以及与 GNU time 相同的扩展：
+ *     %M            各阶段中最大的常驻内存（KB）
+ *     %w / %c       自愿 / 非自愿上下文切换次数
+ *   不认识的 % 序列原样输出。
+ */
+static int format_time(t_strbuf *sb, const char *fmt, double real,
+    const struct rusage *ru)
+{
+    double user = tv_secs(ru->ru_utime);
+    double sys = tv_secs(ru->ru_stime);
+    char buf[64];
+    const char *p;
+    int prec;
+    int lng;
+    int ok = 1;
+
+    p = fmt;
+    while (*p && ok)
+    {
+        if (*p != '%')
+        {
+            ok = sb_append_char(sb, *p++);
+            continue;
+        }
+        fmt = p++;
+        prec = 3;
+        if (*p >= '0' && *p <= '9')
+        {
+            prec = *p++ - '0';
+            if (prec > 3)
+                prec = 3;
+        }
+        lng = (*p == 'l');
+        p += lng;
+        if (*p == '%')
+            ok = sb_append_char(sb, '%');
+        else if (*p == 'R' || *p == 'U' || *p == 'S')
+            ok = put_secs(sb, *p == 'R' ? real : *p == 'U' ? user : sys, prec,
+                lng);
+        else if (*p == 'P' || *p == 'M' || *p == 'w' || *p == 'c')
+        {
+            if (*p == 'P')
+                snprintf(buf, sizeof(buf), "%.2f",
+                    real > 0 ? (user + sys) * 100 / real : 0.0);
+            else
+                snprintf(buf, sizeof(buf), "%ld", *p == 'M' ? ru->ru_maxrss
+                    : *p == 'w' ? ru->ru_nvcsw : ru->ru_nivcsw);
+            ok = sb_append_span(sb, buf, strlen(buf));
+        }
+        else // 不认识的序列（或格式在 % 之后结束）原样输出
+            ok = sb_append_span(sb, fmt, p - fmt + (*p != '\0'));
+        p += (*p != '\0');
+    }
+    return ok;
+}
+
+// time -v：逐个阶段列出资源用量，找出是哪一段吃掉了 CPU
+static void print_stages(ast *n, t_timing *tm, t_minishell *minishell)
+{
+    ast **stages = &n;
+    ast *one = n;
+    struct rusage *ru;
+    char *text;
+    int count = 1;
+
+    if (n->type == NODE_PIPE)
+        stages = flatten_pipeline(n, &count, minishell->arena);
+    if (!stages)
+        stages = (count = 1, &one);
+    for (int i = 0; i < tm->n_stages && i < count; i++)
+    {
+        ru = &tm->stages[i];
+        text = job_text(stages[i]);
+        fprintf(stderr, "[%d]\tuser %.3fs\tsys %.3fs\tmaxrss %ldK\tctxsw %ld/%ld\t%s\n",
+            i + 1, tv_secs(ru->ru_utime), tv_secs(ru->ru_stime), ru->ru_maxrss,
+            ru->ru_nvcsw, ru->ru_nivcsw, text ? text : "");
+        free(text);
+    }
+}
+
+/**
+ * exec_time
+ * ----------------
+ * 目的：
+ *   执行 time pipeline：照常执行管道，结束后在 stderr 报告实际时间、
+ *   用户态 / 内核态 CPU 时间、最大常驻内存与上下文切换次数。
+ *   各阶段的用量来自事件核心收割时的 wait4（见 fg_begin），
+ *   不需要再 exec 一次 /usr/bin/time；shell 进程自己的 CPU 时间（内建命令）另外计入。
+ *   TIMEFORMAT 设为空串时不输出，与 bash 相同。
+ *
+ * 返回值：
+ *   - 管道的退出码
+ */
+int exec_time(ast *n, t_env *env, t_minishell *minishell)
+{
+    t_timing *outer = minishell->timing;
+    int disposable = minishell->disposable;
+    struct timespec t0;
+    struct timespec t1;
+    struct rusage self0;
+    struct rusage self1;
+    struct rusage total;
+    t_timing tm;
+    t_strbuf sb;
+    const char *fmt;
+    int status;
+
+    ft_bzero(&tm, sizeof(tm));
+    ft_bzero(&total, sizeof(total));
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    getrusage(RUSAGE_SELF, &self0);
+    minishell->timing = &tm;
+    minishell->disposable = 0; // 要等管道结束后报告，不能直接 exec 掉
+    status = exec_ast(n->left, env, minishell);
+    minishell->disposable = disposable;
+    minishell->timing = outer;
+    getrusage(RUSAGE_SELF, &self1);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    for (int i = 0; i < tm.n_stages; i++)
+        ru_add(&total, &tm.stages[i]);
+    ru_add_self(&total, &self0, &self1);
+    fmt = env_get(env, "TIMEFORMAT");
+    if (!fmt)
+        fmt = TIME_DEFAULT_FMT;
+    if (n->flags & TIME_POSIX)
+        fmt = TIME_POSIX_FMT;
+    ft_bzero(&sb, sizeof(sb));
+    if (*fmt && format_time(&sb, fmt, (t1.tv_sec - t0.tv_sec)
+            + (t1.tv_nsec - t0.tv_nsec) / 1e9, &total))
+        fprintf(stderr, "%.*s\n", (int)sb.len, sb.buf);
+    sb_free(&sb);
+    if ((n->flags & TIME_VERBOSE) && n->left)
+        print_stages(n->left, &tm, minishell);
+    return status;
+}
@@ -0,0 +1,351 @@
+#include "../../include/minishell.h"
+
+// 把一棵 AST 写回成命令文本（jobs 显示用），追加到 sb
+static int append_ast(t_strbuf *sb, ast *n)
+{
+    static const char *redir_op[] = {"<", ">", ">>", "<<"};
+    const char *sep;
+    t_redir *r;
+    int i;
+
+    if (!n)
+        return 1;
+    if (n->type == NODE_CMD)
+    {
+        i = 0;
+        while (n->argv && n->argv[i])
+        {
+            if ((i > 0 && !sb_append_char(sb, ' '))
+                || !sb_append_span(sb, n->argv[i], strlen(n->argv[i])))
+                return 0;
+            i++;
+        }
+        r = n->redir;
+        while (r)
+        {
+            if ((sb->len > 0 && !sb_append_char(sb, ' '))
+                || !sb_append_span(sb, redir_op[r->type], strlen(redir_op[r->type]))
+                || !sb_append_span(sb, r->filename, strlen(r->filename)))
+                return 0;
+            r = r->next;
+        }
+        return 1;
+    }
+    if (n->type == NODE_SUBSHELL)
+        return (sb_append_char(sb, '(') && append_ast(sb, n->sub)
+            && sb_append_char(sb, ')'));
+    if (n->type == NODE_BACKGROUND)
+        return (append_ast(sb, n->left) && sb_append_span(sb, " &", 2));
+    if (n->type == NODE_TIME)
+        return (sb_append_span(sb, "time ", 5) && append_ast(sb, n->left));
+    sep = " | ";
+    if (n->type == NODE_AND)
+        sep = " && ";
+    else if (n->type == NODE_OR)
+        sep = " || ";
+    else if (n->type == NODE_SEQUENCE)
+        sep = "; ";
+    return (append_ast(sb, n->left) && sb_append_span(sb, sep, strlen(sep))
+        && append_ast(sb, n->right));
+}
+
+// 作业的命令文本（新分配，失败时为 NULL）
+char *job_text(ast *n)
+{
+    t_strbuf sb;
+
+    ft_bzero(&sb, sizeof(sb));
+    if (!append_ast(&sb, n))
+    {
+        sb_free(&sb);
+        return NULL;
+    }
+    return sb_detach(&sb);
+}
+
+// 登记一个新作业，接管 pids 与 cmd（失败时释放它们）。
+// 作业号取当前最大号 + 1；$! 记为最后一个阶段的 pid
+t_job *job_add(t_jobs *jobs, pid_t *pids, int n_pids, char *cmd)
+{
+    t_job *job = calloc(1, sizeof(t_job));
+    t_job **tail = &jobs->head;
+    int k;
+
+    if (!job)
+    {
+        free(pids);
+        free(cmd);
+        return NULL;
+    }
+    job->id = 1;
+    while (*tail)
+    {
+        job->id = (*tail)->id + 1;
+        tail = &(*tail)->next;
+    }
+    *tail = job;
+    job->pids = pids;
+    job->n_pids = n_pids;
+    job->cmd = cmd;
+    for (k = 0; k < n_pids; k++)
+        if (pids[k] > 0)
+            job->n_live++;
+    if (pids[n_pids - 1] > 0)
+        jobs->last_pid = pids[n_pids - 1];
+    return job;
+}
+
+// 从作业表中删除并释放一个作业
+void job_remove(t_jobs *jobs, t_job *job)
+{
+    t_job **p = &jobs->head;
+
+    while (*p && *p != job)
+        p = &(*p)->next;
+    if (*p)
+        *p = job->next;
+    free(job->pids);
+    free(job->cmd);
+    free(job);
+}
+
+// 换算退出码（不像 child_status 那样打印信号提示，后台作业的结束不该打扰前台）
+static int wait_code(int st)
+{
+    if (WIFSIGNALED(st))
+        return 128 + WTERMSIG(st);
+    return WEXITSTATUS(st);
+}
+
+// 事件核心收割到一个子进程：pid 属于本表的某个作业时记下来，返回 1；
+// 不属于本表返回 0。最后一个阶段的状态即作业的状态，ru 是它的资源用量
+int job_done(t_jobs *jobs, pid_t pid, int st, const struct rusage *ru)
+{
+    for (t_job *j = jobs->head; j; j = j->next)
+    {
+        for (int k = 0; k < j->n_pids; k++)
+        {
+            if (j->pids[k] != pid)
+                continue;
+            if (k == j->n_pids - 1)
+            {
+                j->status = wait_code(st);
+                j->wstatus = st;
+            }
+            if (j->ru)
+                j->ru[k] = *ru;
+            j->pids[k] = -pid;
+            j->n_live--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int count_done(t_jobs *jobs)
+{
+    int n = 0;
+
+    for (t_job *j = jobs->head; j; j = j->next)
+        if (j->n_live == 0)
+            n++;
+    return n;
+}
+
+// jobs_reap 的等待条件：比开始时多了结束的作业，或者已经没有在运行的作业
+static int reap_ready(void *arg)
+{
+    t_reap *r = arg;
+
+    if (count_done(r->jobs) > r->before)
+        return 1;
+    for (t_job *j = r->jobs->head; j; j = j->next)
+        if (j->n_live > 0)
+            return 0;
+    return 1;
+}
+
+/**
+ * jobs_reap
+ * ----------------
+ * 目的：
+ *   让事件核心收割已经结束的子进程，更新作业表（作业表须已用 ev_watch 登记）。
+ *
+ * 参数：
+ *   - block : 为 1 时，若没有作业结束且仍有作业在运行，在事件核心上等待，
+ *             直到有作业结束；Ctrl+C 打断等待
+ *
+ * 返回值：
+ *   - 本次新结束的作业数；等待被 SIGINT 打断时返回 -1
+ */
+int jobs_reap(t_jobs *jobs, int block)
+{
+    t_reap r;
+
+    r.jobs = jobs;
+    r.before = count_done(jobs);
+    if (!block)
+        ev_reap();
+    else if (ev_wait(reap_ready, &r, 1) < 0)
+    {
+        write(1, "\n", 1); // 与前台命令被 Ctrl+C 终止时一样换行
+        return -1;
+    }
+    return count_done(jobs) - r.before;
+}
+
+// 前台等待的条件：所有阶段都已收割
+static int fg_ready(void *arg)
+{
+    return ((t_job *)arg)->n_live == 0;
+}
+
+// 开始一条前台命令：pids[0 .. n) 登记为一个临时作业（不进作业表、没有作业号），
+// 从此它的子进程由事件核心收割。必须在 shell 自己可能收割子进程之前调用
+// （lastpipe 的内建阶段里可能执行 wait / parallel）。
+// 在 time 之下时还按阶段记下资源用量
+void fg_begin(t_fg *fg, pid_t *pids, int n, t_minishell *minishell)
+{
+    ft_bzero(fg, sizeof(*fg));
+    if (minishell->timing && n > 0)
+        fg->job.ru = arena_calloc(minishell->arena, n, sizeof(struct rusage));
+    fg->job.pids = pids;
+    fg->job.n_pids = n;
+    fg->job.wstatus = -1;
+    for (int k = 0; k < n; k++)
+        if (pids[k] > 0)
+            fg->job.n_live++;
+    fg->table.head = &fg->job;
+    fg->watched = ev_watch(&fg->table);
+}
+
+/**
+ * fg_end
+ * ----------------
+ * 目的：
+ *   等前台命令的所有阶段结束并注销。Ctrl+C 不打断等待：
+ *   前台进程自己收到 SIGINT，等它们结束即可。
+ *
+ * 返回值：
+ *   - 最后一个阶段的退出码（经 child_status，被信号终止时打印提示）；
+ *     最后一个阶段没能启动时为 last_status
+ */
+int fg_end(t_fg *fg, int last_status, t_minishell *minishell)
+{
+    struct rusage ru;
+    uint64_t t = trace_now();
+    int st;
+
+    if (fg->watched)
+    {
+        ev_wait(fg_ready, &fg->job, 0);
+        ev_unwatch(&fg->table);
+    }
+    for (int k = 0; !fg->watched && k < fg->job.n_pids; k++)
+        if (fg->job.pids[k] > 0 && wait4(fg->job.pids[k], &st, 0, &ru) > 0)
+        {
+            spawn_reaped(fg->job.pids[k], st);
+            job_done(&fg->table, fg->job.pids[k], st, &ru);
+        }
+    if (fg->job.ru && minishell->timing)
+    {
+        minishell->timing->stages = fg->job.ru;
+        minishell->timing->n_stages = fg->job.n_pids;
+    }
+    trace_span("wait", t, "stages", fg->job.n_pids);
+    if (fg->job.wstatus != -1)
+        return child_status(fg->job.wstatus);
+    return last_status;
+}
+
+// 按 bash 的格式打印一个作业：[1]+  Running                 sleep 5 &
+// mark：'+' 当前作业（最近启动的），'-' 上一个，其余为空格
+static void print_job(t_job *j, char mark)
+{
+    char state[32];
+    int sig;
+
+    if (j->n_live > 0)
+        snprintf(state, sizeof(state), "Running");
+    else if (j->status > 128 && (sig = j->status - 128) < NSIG)
+        snprintf(state, sizeof(state), "%s", strsignal(sig));
+    else if (j->status)
+        snprintf(state, sizeof(state), "Exit %d", j->status);
+    else
+        snprintf(state, sizeof(state), "Done");
+    printf("[%d]%c  %-24s%s%s\n", j->id, mark, state, j->cmd ? j->cmd : "",
+        j->n_live > 0 ? " &" : "");
+}
+
+// 作业的标记：最后一个是 '+'，倒数第二个是 '-'
+static char job_mark(t_job *j)
+{
+    if (!j->next)
+        return '+';
+    if (!j->next->next)
+        return '-';
+    return ' ';
+}
+
+/**
+ * jobs_notify
+ * ----------------
+ * 目的：
+ *   收割后按 jobs 的格式报告已经结束的作业，并把它们从表中删除
+ *   （交互模式在显示提示符之前调用，与 bash 相同）。
+ *   all 为 1 时还列出仍在运行的作业（jobs 内建）。
+ */
+void jobs_notify(t_jobs *jobs, int all)
+{
+    t_job *j;
+    t_job *next;
+
+    jobs_reap(jobs, 0);
+    for (j = jobs->head; j; j = next)
+    {
+        next = j->next;
+        if (j->n_live == 0 || all)
+            print_job(j, job_mark(j));
+        if (j->n_live == 0)
+            job_remove(jobs, j);
+    }
+    fflush(stdout);
+}
+
+/**
+ * jobs_prune
+ * ----------------
+ * 目的：
+ *   非交互模式（-c、脚本、批处理）每行结束时调用：收割后把已经结束的作业
+ *   不声不响地删掉。这些模式没有提示符前的报告（jobs_notify），
+ *   否则结束的作业会一直留在表里，作业号越来越大。
+ *   $! 的作业被删掉时记下它的退出码，供之后的 wait $! 使用。
+ */
+void jobs_prune(t_jobs *jobs)
+{
+    t_job *j;
+    t_job *next;
+
+    if (!jobs->head)
+        return;
+    jobs_reap(jobs, 0);
+    for (j = jobs->head; j; j = next)
+    {
+        next = j->next;
+        if (j->n_live > 0)
+            continue;
+        if (jobs->last_pid > 0 && j->pids[j->n_pids - 1] == -jobs->last_pid)
+        {
+            jobs->pruned_pid = jobs->last_pid;
+            jobs->pruned_status = j->status;
+        }
+        job_remove(jobs, j);
+    }
+}
+
+// 退出时释放作业表（仍在运行的作业不等待，与 bash 相同）
+void jobs_free(t_jobs *jobs)
+{
+    while (jobs->head)
+        job_remove(jobs, jobs->head);
+}
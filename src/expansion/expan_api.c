@@ -13,27 +13,26 @@
 #include "../../include/minishell.h"
 
 
-// 做什么：单字符串版本：tmp = expand_all(minishell, str) → clean = remove_quotes_flag(tmp, ...)（若没引号就 ft_strdup(tmp)）→ 释放 tmp 和旧 str → 返回 clean。
+// 做什么：单字符串版本：quote_scan 生成注解 → expand_word(strip = 1) 一遍完成展开与去引号 → 释放旧 str → 返回新串。
 // 输入：str（会被函数内部 free）。
 // 输出：新堆串或 NULL。
 // 谁调：解析重定向目标时可以用（如果没使用 expander_list 统一处理）。
-// 调用到的外部函数：expand_all（本模块）、remove_quotes_flag（在 lexer_remove_quotes.c）。
+// 调用到的外部函数：quote_scan（在 lexer_quote.c）、expand_word（本模块）。
 char *expander_str(t_minishell *minishell, char *str)
 {
-	char *tmp, *clean;
-	int had_q, q_s, q_d;
+	unsigned char *ctx;
+	char *clean;
 
 	if (!str)
 		return (NULL);
-	tmp = expand_all(minishell, str);
-	if (!tmp)
+	ctx = malloc(ft_strlen(str) + 1);
+	if (!ctx)
 		return (NULL);
-	clean = remove_quotes_flag(tmp, &had_q, &q_s, &q_d);
-	if (!clean)
-		clean = ft_strdup(tmp);
-	free(tmp);
+	quote_scan(str, ctx);
+	clean = expand_word(minishell, str, ctx, 1);
+	free(ctx);
 	if (!clean)
 		return (NULL);
 	free(str);
 	return (clean);
-}
\ No newline at end of file
+}
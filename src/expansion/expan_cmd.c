@@ -0,0 +1,65 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   expan_cmd.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 19:02:41 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 19:02:41 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+// 做什么：按解析时记下的引号注解展开一个单词并去引号，结果拷进本行 arena。
+// 输入：msh、原文切片 src、它的注解 ctx。
+// 输出：新串或 NULL（内存失败）。
+// 谁调：expand_cmd。
+static char	*expand_deferred(t_minishell *msh, const char *src,
+		const unsigned char *ctx)
+{
+	t_strbuf	*sb;
+
+	msh->exp_expanded++;
+	sb = &msh->expand_buf;
+	sb_reset(sb);
+	if (!expand_word_sb(sb, msh, src, ctx))
+		return (NULL);
+	return (arena_strndup(msh->arena, sb->buf, sb->len));
+}
+
+// 做什么：执行一个简单命令之前，完成解析时推迟的 $ 展开：
+// argq[i] 非空的参数、fq 非空的重定向目标按各自的注解展开，替换原文切片。
+// 展开后清空注解，同一个节点再次经过（如管道阶段先在父进程展开，
+// fork 后又进入 exec_cmd_node）不会重复展开。
+// 输入：msh、NODE_CMD 节点 n。
+// 输出：1 成功 / 0 内存失败。
+// 谁调：exec_cmd_node、exec_pipeline（启动各阶段之前）。
+int	expand_cmd(t_minishell *msh, ast *n)
+{
+	t_redir	*r;
+	int		i;
+
+	i = 0;
+	while (n->argq && n->argv[i])
+	{
+		if (n->argq[i])
+			n->argv[i] = expand_deferred(msh, n->argv[i], n->argq[i]);
+		if (!n->argv[i])
+			return (0);
+		i++;
+	}
+	n->argq = NULL;
+	r = n->redir;
+	while (r)
+	{
+		if (r->fq)
+			r->filename = expand_deferred(msh, r->filename, r->fq);
+		if (!r->filename)
+			return (0);
+		r->fq = NULL;
+		r = r->next;
+	}
+	return (1);
+}
@@ -28,54 +28,17 @@ int	var_len(const char *s)
 	return (i);
 }
 
-/*
-** 做什么：
-**   返回 entry 中第一个 '=' 的索引位置。
-**   若没找到 '='，则返回字符串长度（即 '\0' 的位置）。
-**
-** 举例：
-**   "PATH=/usr/bin" → 4
-**   "HOME=/home/user" → 4
-**   "SHELL" → 5（即 strlen("SHELL")）
-**
-** 谁调：
-**   env_value_dup()（在解析环境变量名时）
-*/
-size_t	equal_sign(const char *entry)
+// 做什么：在变量表 minishell->env 中按 name[0..len-1] 查变量（哈希，平均 O(1)），返回指向值的指针（不拷贝）；找不到或没有值返回 ""。
+// 谁调：handle_var_exp → scan_expand_one（结果直接追加进 builder）。
+const char	*env_value_ref(t_minishell *minishell, const char *name, int len)
 {
-	int	i;
-
-	if (!entry)
-		return (0);
-	i = 0;
-	while (entry[i] && entry[i] != '=')
-		i++;
-	return (i);
+	const char	*v;
+
+	if (!minishell)
+		return ("");
+	stats_add(STC_ENV_LOOKUPS, 1);
+	v = env_get_n(minishell->env, name, len);
+	if (!v)
+		return ("");
+	return (v);
 }
-
-// 做什么：在 minishell->envp 中找 name[0..len-1] 的环境变量，返回值的 ft_strdup；找不到返回 ft_strdup("")。
-// 实现细节：用 equal_sign(entry) 找 = 的位置，兼容不同返回语义；比较 key 后，值从 keylen+1（若 entry[keylen]=='='）或 keylen 开始。
-// 谁调：handle_var_exp → scan_expand_one。
-char	*env_value_dup(t_minishell *minishell, const char *name, int len)
-{
-	int		k;
-	int		keylen;
-	char	*entry;
-
-	if (!minishell || !minishell->envp)
-		return (ft_strdup(""));
-	k = 0;
-	while (minishell->envp[k])
-	{
-		entry = minishell->envp[k];
-		keylen = equal_sign(entry);
-		if (keylen == len && ft_strncmp(name, entry, len) == 0)
-		{
-			if (entry[keylen] == '=')
-				return (ft_strdup(entry + keylen + 1));
-			return (ft_strdup(entry + keylen));
-		}
-		k++;
-	}
-	return (ft_strdup(""));
-}
\ No newline at end of file
@@ -13,53 +13,30 @@
 #include "../../include/minishell.h"
 
 
-// 做什么：从当前 node 开始，在下一个 | 之前找本段第一个 TOK_WORD，检查是否精确等于 "export"。
-// 输出：1 是 export 段 / 0 否。
-// 谁调：expander_list，用于决定本段 TOK_WORD 是否要保留引号。
-static int	is_export_segment(t_lexer *node)
-{
-	t_lexer	*p;
-
-	p = node;
-	while (p && p->tokentype != TOK_PIPE)
-	{
-		if (p->tokentype == TOK_WORD && p->str && p->str[0])
-		{
-			if (p->str[0] == 'e' && p->str[1] == 'x' && p->str[2] == 'p'
-				&& p->str[3] == 'o' && p->str[4] == 'r' && p->str[5] == 't'
-				&& p->str[6] == '\0')
-				return (1);
-			return (0);
-		}
-		p = p->next;
-	}
-	return (0);
-}
-
-// 做什么：按管道段遍历整条链表：
-// 每段先 export_mode = is_export_segment(p)；
-// 在该段内：对每个 token 调 expand_token(minishell, node, export_mode)；
-// 遇到 TOK_PIPE 切到下一段。
-// 输入：minishell、链表头 head。
+// 做什么：解析前遍历整个 token 序列，对能提前定下最终值的 WORD 调 expand_token：
+// 只需去引号的 WORD 在这里完成；含 $ 的 WORD 的值取决于前面命令执行后的
+// 变量与 $?（a && b、a ; b 中 b 的展开要在 a 执行之后），留给执行时的
+// expand_cmd 处理，str 暂时就是原文切片，raw 保留。
+// 例外：heredoc 的 delimiter 与 here-string 的 word 在解析时就要用到，照常展开。
+// 去引号统一按词法阶段的引号注解进行，export 段与其它命令没有区别
+// （export 收到的参数已经是最终值）。
+// 输入：minishell、token 序列 toks。
 // 输出：1 成功 / 0 失败（任一 expand_token 失败）。
-// 谁调：词法结束后、解析/执行前的主流程里调用一次。
-int	expander_list(t_minishell *minishell, t_lexer *head)
+// 谁调：词法结束后、解析前的主流程里调用一次。
+int	expander_list(t_minishell *minishell, t_tokens *toks)
 {
-	t_lexer	*p;
-	int		export_mode;
+	int	i;
 
-	p = head;
-	while (p)
+	i = 0;
+	while (i < toks->count)
 	{
-		export_mode = is_export_segment(p);
-		while (p && p->tokentype != TOK_PIPE)
-		{
-			if (!expand_token(minishell, p, export_mode))
-				return (0);
-			p = p->next;
-		}
-		if (p && p->tokentype == TOK_PIPE)
-			p = p->next;
+		if (toks->type[i] == TOK_WORD && (toks->flags[i] & TOKF_NEEDS_EXPAND)
+			&& !(i > 0 && (toks->type[i - 1] == TOK_HEREDOC
+					|| toks->type[i - 1] == TOK_HERESTRING)))
+			toks->str[i] = toks->raw[i];
+		else if (!expand_token(minishell, toks, i))
+			return (0);
+		i++;
 	}
 	return (1);
 }
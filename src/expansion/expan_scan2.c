@@ -1,72 +1,101 @@
 #include "../../include/minishell.h"
 
-static void	toggle_quote_state(const char c, enum qstate *q)
+// 做什么：expand_word 系列的主循环。stop 为需要特殊处理的注解位：
+// 含 QC_DELIM 时丢弃引号本身（去引号），QC_EXP 时展开 $；
+// 注解与 stop 无交集的字节整段批量追加。
+// 输出：1 成功 / 0 内存失败。
+static int	expand_into(t_strbuf *sb, t_minishell *minishell, const char *str,
+		const unsigned char *ctx, int stop)
 {
-    if (c == '\'' && *q != Q_DQ)
-    {
-        if (*q == Q_SQ)
-            *q = Q_NONE;
-        else
-            *q = Q_SQ;
-    }
-    else if (c == '\"' && *q != Q_SQ)
-    {
-        if (*q == Q_DQ)
-            *q = Q_NONE;
-        else
-            *q = Q_DQ;
-    }
+	t_exp_data	data;
+	int			i;
+	int			run;
+	int			used;
+
+	data.minishell = minishell;
+	data.out = sb;
+	if (!sb_reserve(sb, 0))
+		return (0);
+	i = 0;
+	while (str[i])
+	{
+		run = 0;
+		while (str[i + run] && !(ctx[i + run] & stop))
+			run++;
+		if (run && !sb_append_span(sb, str + i, run))
+			return (0);
+		i += run;
+		if (!str[i])
+			break ;
+		if (ctx[i] & QC_EXP)
+		{
+			used = scan_expand_one(&data, str, i);
+			if (used < 0)
+				return (0);
+			i += used;
+		}
+		else
+			i++;
+	}
+	return (1);
 }
 
+// 做什么：把 str 按引号注解展开并去引号，结果追加到 sb：
+// 遍历 str[i]（ctx[i] 是同一字节的注解，来自 quote_scan）：
+// 开/闭引号本身（QC_DELIM）→ 跳过；
+// 可展开的 $（QC_EXP）→ i += scan_expand_one(&data, str, i)；
+// 其余字节 → 找出到下一个引号/$ 为止的整段，一次 sb_append_span 批量拷贝。
+// 变量值里的引号字符没有注解，原样保留（与 bash 一致）。
+// 输入：输出 builder、minishell（为了 $?/env）、str、ctx。
+// 输出：1 成功 / 0 内存失败。
+// 谁调：expand_token（复用 minishell 里的 builder）、expand_word。
+int	expand_word_sb(t_strbuf *sb, t_minishell *minishell, const char *str,
+		const unsigned char *ctx)
+{
+	return (expand_into(sb, minishell, str, ctx, QC_DELIM | QC_EXP));
+}
 
-// 做什么：把单字符 c 追加到 *out（用 str_join_free）。
-// 输出：固定 1（表示“我消费了 1 个字符”）。
-// 谁调：expand_all 遇到普通字符时。
-static int	append_char(const char c, char **out)
+// 做什么：按引号注解一次完成展开与（可选的）去引号，返回独立堆串。
+// 输入：minishell、str、ctx、是否去引号。
+// 输出：新堆串（调用者 free）或 NULL。
+// 谁调：expand_all、expander_str。
+char	*expand_word(t_minishell *minishell, const char *str,
+		const unsigned char *ctx, int strip)
 {
-	char	buf[2];
+	t_strbuf	sb;
+	int			stop;
 
-	buf[0] = c;
-	buf[1] = '\0';
-	*out = str_join_free(*out, buf);
-	return (1);
+	if (!str || !ctx)
+		return (NULL);
+	ft_bzero(&sb, sizeof(sb));
+	stop = QC_EXP;
+	if (strip)
+		stop |= QC_DELIM;
+	if (!expand_into(&sb, minishell, str, ctx, stop))
+	{
+		sb_free(&sb);
+		return (NULL);
+	}
+	return (sb_detach(&sb));
 }
 
-
-// 做什么：整串展开（保留引号字符）
-// 初始化 out=""、q=Q_NONE；
-// 遍历 str[i]：
-// 先 toggle_quote_state(str[i])；
-// 若 str[i] == '$' → i += scan_expand_one(&data, str, i, q)；
-// 否则 → i += append_char(str[i], &out)；
-// 返回 out（堆串）。
-// 输入：minishell（为了 $?/env）、str 原始片段（最好是 raw）。
+// 做什么：没有现成注解的字符串的整串展开（保留引号字符）：
+// 先 quote_scan 生成临时注解，再 expand_word(strip = 0)。
+// 输入：minishell、str。
 // 输出：新堆串（只做 $ 展开，不去引号）。
-// 谁调：expand_token、expander_str、测试。
+// 谁调：需要展开任意字符串的地方。
 char	*expand_all(t_minishell *minishell, const char *str)
 {
-	int			i;
-	char		*out;
-	enum qstate	q;
-	t_exp_data	data;
+	unsigned char	*ctx;
+	char			*out;
 
-	data.minishell = minishell;
 	if (!str)
 		return (NULL);
-	i = 0;
-	q = Q_NONE;
-	out = ft_strdup("");
-	if (!out)
+	ctx = malloc(ft_strlen(str) + 1);
+	if (!ctx)
 		return (NULL);
-	data.minishell = minishell;
-	data.out = &out;
-	while (str[i])
-	{
-		toggle_quote_state(str[i], &q);
-		if (str[i] == '$')
-			i += scan_expand_one(&data, str, i, q);
-		else
-			i += append_char(str[i], &out);
-	}
+	quote_scan(str, ctx);
+	out = expand_word(minishell, str, ctx, 0);
+	free(ctx);
 	return (out);
-}
\ No newline at end of file
+}
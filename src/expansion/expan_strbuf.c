@@ -0,0 +1,98 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   expan_strbuf.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 13:20:07 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 13:20:07 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+// 做什么：保证 sb 还能再放下 extra 个字节（外加结尾 '\0'），不够就按 2 倍扩容。
+// 输出：1 成功 / 0 内存失败（原内容保持不变）。
+// 谁调：sb_append_*。
+int	sb_reserve(t_strbuf *sb, size_t extra)
+{
+	size_t	need;
+	size_t	cap;
+	char	*nbuf;
+
+	need = sb->len + extra + 1;
+	if (need <= sb->cap)
+		return (1);
+	cap = sb->cap;
+	if (cap < SB_INIT_CAP)
+		cap = SB_INIT_CAP;
+	while (cap < need)
+		cap *= 2;
+	nbuf = malloc(cap);
+	if (!nbuf)
+		return (0);
+	if (sb->buf)
+		ft_memcpy(nbuf, sb->buf, sb->len);
+	free(sb->buf);
+	sb->buf = nbuf;
+	sb->cap = cap;
+	return (1);
+}
+
+// 做什么：追加 s[0..n)（一次 memcpy，用于整段未展开的原文）。
+// 输出：1 成功 / 0 内存失败。
+// 谁调：expand_word、handle_var_exp、handle_special_exp。
+int	sb_append_span(t_strbuf *sb, const char *s, size_t n)
+{
+	if (!sb_reserve(sb, n))
+		return (0);
+	ft_memcpy(sb->buf + sb->len, s, n);
+	sb->len += n;
+	sb->buf[sb->len] = '\0';
+	return (1);
+}
+
+// 做什么：追加单个字符。
+// 输出：1 成功 / 0 内存失败。
+int	sb_append_char(t_strbuf *sb, char c)
+{
+	if (!sb_reserve(sb, 1))
+		return (0);
+	sb->buf[sb->len++] = c;
+	sb->buf[sb->len] = '\0';
+	return (1);
+}
+
+// 做什么：把已构建的内容作为独立堆串交给调用者，sb 回到空状态。
+// 输出：堆串（调用者 free）；内存失败返回 NULL。
+// 谁调：expand_word（需要返回堆串的接口）。
+char	*sb_detach(t_strbuf *sb)
+{
+	char	*out;
+
+	if (!sb_reserve(sb, 0))
+		return (NULL);
+	out = sb->buf;
+	sb->buf = NULL;
+	sb->len = 0;
+	sb->cap = 0;
+	return (out);
+}
+
+// 做什么：清空内容但保留缓冲区，供下一个 token 复用（O(1)）。
+void	sb_reset(t_strbuf *sb)
+{
+	sb->len = 0;
+	if (sb->buf)
+		sb->buf[0] = '\0';
+}
+
+// 做什么：释放 sb 的缓冲区并清零（进程退出时或临时 sb 用完时）。
+void	sb_free(t_strbuf *sb)
+{
+	free(sb->buf);
+	sb->buf = NULL;
+	sb->len = 0;
+	sb->cap = 0;
+}
@@ -16,53 +16,62 @@
 #include "../../libft/libft.h"
 
 typedef struct s_minishell t_minishell;
-typedef struct s_lexer t_lexer;
+typedef struct s_tokens t_tokens;
 
-/* 引号状态机（字符级扫描时使用）
- * 作用：expand_all/scan_expand_one 在**逐字符**扫描时，随时知道
- * 当前字符处于什么引号环境，从而决定 $ 是否展开。
- * - Q_NONE：不在引号里；
- * - Q_SQ  ：在单引号 '...' 内 → 禁止 $ 展开；
- * - Q_DQ  ：在双引号 "..." 内 → 允许 $ 展开（仅做变量替换，不干预分词/通配）。
+/* 可增长字符串（string builder）
+ * 作用：展开时把输出逐段追加到同一块缓冲区，容量不够按 2 倍扩容，
+ * 避免每追加一个字符就整串重新分配、拷贝。
+ * - buf：缓冲区（总是以 '\0' 结尾，未分配时为 NULL）；
+ * - len：已写入的字节数；
+ * - cap：缓冲区容量。
+ * 全零即为合法的空 builder。
  */
-enum qstate
+#define SB_INIT_CAP 64
+
+typedef struct s_strbuf
 {
-	Q_NONE = 0,
-	Q_SQ = 1,
-	Q_DQ = 2
-};
+	char *buf;
+	size_t len;
+	size_t cap;
+} t_strbuf;
 
 /* 扩展时的临时“小包”（传参用）
  * 作用：把全局上下文和“输出字符串指针”打包传给字符级函数。
  * 字段说明：
  * - minishell：指向全局上下文（读 envp、last_exit_status 等）；
- * - out      ：指向“输出字符串”的指针地址。字符级函数会不断拼接内容，
- *              需要能修改调用者持有的指针（所以是 char **）。
+ * - out      ：输出 builder，展开结果都追加到这里。
  */
 typedef struct s_exp_data
 {
 	t_minishell *minishell;
-	char **out;
+	t_strbuf *out;
 } t_exp_data;
 
 int expander_list(t_minishell *minishell,
-				  t_lexer *head);
+				  t_tokens *toks);
 char *expander_str(t_minishell *minishell, char *str);
+int expand_cmd(t_minishell *msh, ast *n);
 
-int scan_expand_one(t_exp_data *data, const char *s,
-					int j, enum qstate q);
-int expand_token(t_minishell *msh, t_lexer *node,
-				 int export_mode);
+int scan_expand_one(t_exp_data *data, const char *s, int j);
+int expand_token(t_minishell *msh, t_tokens *toks, int i);
 char *expand_all(t_minishell *minishell,
 				 const char *str);
+char *expand_word(t_minishell *minishell, const char *str,
+				  const unsigned char *ctx, int strip);
+int expand_word_sb(t_strbuf *sb, t_minishell *minishell,
+				   const char *str, const unsigned char *ctx);
 
 int is_name_start(int c);
 int is_name_char(int c);
 int var_len(const char *s);
-char *env_value_dup(t_minishell *minishell,
-					const char *name, int len);
+const char *env_value_ref(t_minishell *minishell,
+						  const char *name, int len);
 
-char *str_join_free(char *a, const char *b);
-size_t equal_sign(const char *entry);
+int sb_reserve(t_strbuf *sb, size_t extra);
+int sb_append_span(t_strbuf *sb, const char *s, size_t n);
+int sb_append_char(t_strbuf *sb, char c);
+char *sb_detach(t_strbuf *sb);
+void sb_reset(t_strbuf *sb);
+void sb_free(t_strbuf *sb);
 
 #endif
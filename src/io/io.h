@@ -0,0 +1,107 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   io.h                                               :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:20:07 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 16:20:07 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef IO_H
+#define IO_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+/* 读写缓冲区的默认大小 */
+#define IO_BUF_SIZE 65536
+
+/* 读取器怎样从 fd 取数据（见 rd_fill） */
+typedef enum e_rd_mode
+{
+	RD_BLOCK,	// 大块 read：fd 只归这个读取器
+	RD_BYTE,	// 一次读一个字节：与子进程共用、不能 seek 的 fd，
+				// 不读过当前行，后面的数据留给要读标准输入的命令
+	RD_PEEK,	// 管道：先用 tee 复制出管道里现有的数据看一眼（不消费），
+				// 再只读走到第一个换行符为止；效果同 RD_BYTE，每行只需三次系统调用
+	RD_PREAD,	// 普通文件：从 off 大块 pread，不移动文件偏移；
+				// 子进程看到的位置由 rd_sync 设置
+}	t_rd_mode;
+
+/**
+ * s_reader
+ * ----------------
+ * 一个 fd 上的带缓冲的按行读取器，每个 fd 一个对象，互不干扰。
+ * - fd          : 读取的 fd；-1 表示内存读取器（见 rd_init_mem），
+ *                 数据就是 buf 本身，读完即结束，buf 不归读取器释放
+ * - buf / cap   : 缓冲区（行比缓冲区长时按需翻倍）
+ * - start / end : [start, end) 是已读入、尚未消费的数据
+ * - mode / off  : 读取方式；RD_PREAD 时 off 是 buf[end] 在文件中的位置
+ * - peek        : RD_PEEK 用的私有管道（读端、写端），其他方式为 -1
+ * - stop        : 非 NULL 时 RD_PEEK 一次可以读走多行，直到内容等于 stop
+ *                 的那一行为止（heredoc 正文，见 rd_set_stop）
+ */
+typedef struct s_reader
+{
+	int fd;
+	char *buf;
+	size_t cap;
+	size_t start;
+	size_t end;
+	t_rd_mode mode;
+	off_t off;
+	int peek[2];
+	const char *stop;
+	size_t stop_len;
+} t_reader;
+
+/**
+ * s_line
+ * ----------------
+ * rd_line 返回的一行：指向 reader 缓冲区内部的视图，不拷贝。
+ * 下一次调用 rd_* 之前有效。换行符（以及它前面的 '\r'）不包含在 len 内；
+ * has_nl 为 0 表示这是文件末尾没有换行符的最后一行。
+ */
+typedef struct s_line
+{
+	const char *ptr;
+	size_t len;
+	int has_nl;
+} t_line;
+
+/**
+ * s_writer
+ * ----------------
+ * 带缓冲的写入器：小块写入先攒进 buf，满了或 wr_flush 时一次写出。
+ */
+typedef struct s_writer
+{
+	int fd;
+	char *buf;
+	size_t cap;
+	size_t len;
+} t_writer;
+
+int rd_init(t_reader *r, int fd, size_t cap);
+void rd_init_mem(t_reader *r, char *buf, size_t len);
+void rd_free(t_reader *r);
+int rd_line(t_reader *r, t_line *line);
+int rd_buffered(t_reader *r);
+int rd_ready(t_reader *r);
+void rd_set_stop(t_reader *r, const char *line);
+off_t rd_tell(t_reader *r);
+void rd_sync(t_reader *r, off_t pos);
+int rd_resync(t_reader *r, off_t pos);
+t_reader *rd_stdin(void);
+
+int io_write_all(int fd, const char *s, size_t n);
+int wr_init(t_writer *w, int fd, size_t cap);
+int wr_put(t_writer *w, const char *s, size_t n);
+int wr_flush(t_writer *w);
+void wr_free(t_writer *w);
+
+#endif
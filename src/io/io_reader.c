@@ -0,0 +1,397 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   io_reader.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:20:07 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 16:20:07 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#define _GNU_SOURCE
+#include "../../include/minishell.h"
+#include <poll.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+/**
+ * rd_init
+ * ----------------
+ * 目的：
+ *   为 fd 建立一个读取器，缓冲区大小为 cap（0 表示 IO_BUF_SIZE）。
+ *   成功返回 1，内存不足返回 0。
+ */
+int rd_init(t_reader *r, int fd, size_t cap)
+{
+	if (cap == 0)
+		cap = IO_BUF_SIZE;
+	r->fd = fd;
+	r->cap = cap;
+	r->start = 0;
+	r->end = 0;
+	r->mode = RD_BLOCK;
+	r->off = 0;
+	r->peek[0] = -1;
+	r->peek[1] = -1;
+	r->stop = NULL;
+	r->stop_len = 0;
+	r->buf = malloc(cap);
+	return (r->buf != NULL);
+}
+
+/**
+ * rd_init_mem
+ * ----------------
+ * 目的：
+ *   在一段已有的内存（如 mmap 的脚本）上建立读取器：不拷贝、不 read，
+ *   rd_line 直接返回指向这段内存的视图，这段内存由调用者管理。
+ */
+void rd_init_mem(t_reader *r, char *buf, size_t len)
+{
+	r->fd = -1;
+	r->buf = buf;
+	r->cap = len;
+	r->start = 0;
+	r->end = len;
+	r->mode = RD_BLOCK;
+	r->off = 0;
+	r->peek[0] = -1;
+	r->peek[1] = -1;
+	r->stop = NULL;
+	r->stop_len = 0;
+}
+
+void rd_free(t_reader *r)
+{
+	if (r->fd >= 0)
+		free(r->buf);
+	if (r->peek[0] >= 0)
+		close(r->peek[0]);
+	if (r->peek[1] >= 0)
+		close(r->peek[1]);
+	r->peek[0] = -1;
+	r->peek[1] = -1;
+	r->buf = NULL;
+	r->cap = 0;
+	r->start = 0;
+	r->end = 0;
+}
+
+/**
+ * rd_peek_cut
+ * ----------------
+ * 目的：
+ *   看过的 n 个字节（在 buf[end] 处）里应该真正读走多少：
+ *   读到第一个换行符为止；设置了 stop 时逐行比较，读到等于 stop 的那一行为止，
+ *   没有这一行就读到最后一个换行符（之前的行都是 heredoc 正文）。
+ *   比较从当前还没读完的一行的开头算起，它可能有一部分已在缓冲区里。
+ */
+static ssize_t rd_peek_cut(t_reader *r, ssize_t n)
+{
+	char *end;
+	char *p;
+	char *nl;
+	char *cut;
+	size_t len;
+
+	end = r->buf + r->end + n;
+	p = memrchr(r->buf + r->start, '\n', r->end - r->start);
+	p = p ? p + 1 : r->buf + r->start;
+	cut = NULL;
+	while ((nl = memchr(p, '\n', end - p)))
+	{
+		cut = nl + 1;
+		len = nl - p;
+		if (len > 0 && p[len - 1] == '\r')
+			len--;
+		if (!r->stop || (len == r->stop_len && memcmp(p, r->stop, len) == 0))
+			break ;
+		p = nl + 1;
+	}
+	if (!cut)
+		return (n);
+	return (cut - (r->buf + r->end));
+}
+
+/**
+ * rd_peek_line
+ * ----------------
+ * 目的：
+ *   RD_PEEK 的一次读取：tee 把管道里现有的数据（没有时阻塞等待）复制进
+ *   私有管道，从那里读出来找换行符，再从 fd 真正读走到换行符为止
+ *   （数据相同，直接读进同一处，见 rd_peek_cut）。之后的数据留在 fd 里。
+ *   fd 不是管道（tee 报 EINVAL）时退回 RD_BYTE。
+ *
+ * 返回值：
+ *   同 rd_fill
+ */
+static ssize_t rd_peek_line(t_reader *r)
+{
+	size_t want;
+	ssize_t n;
+	ssize_t got;
+	ssize_t k;
+
+	want = r->cap - r->end;
+	if (want > IO_BUF_SIZE)
+		want = IO_BUF_SIZE;
+	n = tee(r->fd, r->peek[1], want, 0);
+	if (n < 0 && errno == EINVAL)
+	{
+		r->mode = RD_BYTE;
+		return (read(r->fd, r->buf + r->end, 1));
+	}
+	if (n <= 0)
+		return (n);
+	got = 0;
+	while (got < n)
+	{
+		k = read(r->peek[0], r->buf + r->end + got, n - got);
+		if (k <= 0)
+			return (-1);
+		got += k;
+	}
+	return (read(r->fd, r->buf + r->end, rd_peek_cut(r, n)));
+}
+
+/**
+ * rd_fill
+ * ----------------
+ * 目的：
+ *   再读一次 fd，追加到未消费数据之后。
+ *   先把未消费的数据挪到缓冲区开头；缓冲区已满（一行比缓冲区还长）则翻倍。
+ *
+ * 内存读取器没有更多数据可读，直接返回 0。
+ * RD_BYTE 每次只读一个字节，RD_PEEK 最多读到一个换行符为止，
+ * RD_PREAD 从 off 读、不移动 fd 的文件偏移。
+ *
+ * 返回值：
+ *   读到的字节数；0 表示文件结束；-1 表示出错（errno 保留，EINTR 也原样返回，
+ *   让调用者有机会检查 Ctrl+C）
+ */
+static ssize_t rd_fill(t_reader *r)
+{
+	char *grown;
+	ssize_t n;
+
+	if (r->fd < 0)
+		return (0);
+	if (r->start > 0)
+	{
+		memmove(r->buf, r->buf + r->start, r->end - r->start);
+		r->end -= r->start;
+		r->start = 0;
+	}
+	if (r->end == r->cap)
+	{
+		grown = realloc(r->buf, r->cap * 2);
+		if (!grown)
+			return (-1);
+		r->buf = grown;
+		r->cap *= 2;
+	}
+	if (r->mode == RD_PREAD)
+		n = pread(r->fd, r->buf + r->end, r->cap - r->end, r->off);
+	else if (r->mode == RD_BYTE)
+		n = read(r->fd, r->buf + r->end, 1);
+	else if (r->mode == RD_PEEK)
+		n = rd_peek_line(r);
+	else
+		n = read(r->fd, r->buf + r->end, r->cap - r->end);
+	if (n > 0)
+		r->end += n;
+	if (n > 0 && r->mode == RD_PREAD)
+		r->off += n;
+	return (n);
+}
+
+/**
+ * rd_line
+ * ----------------
+ * 目的：
+ *   取下一行，结果是指向缓冲区的视图（见 t_line），不做拷贝。
+ *   "\n" 与 "\r\n" 都视为行尾。
+ *
+ * 返回值：
+ *   1 取到一行；0 文件结束且没有剩余数据；-1 出错（errno 保留）
+ */
+int rd_line(t_reader *r, t_line *line)
+{
+	size_t seen;
+	char *nl;
+	ssize_t n;
+
+	seen = 0;
+	while (1)
+	{
+		nl = memchr(r->buf + r->start + seen, '\n', r->end - r->start - seen);
+		if (nl)
+			break ;
+		seen = r->end - r->start; // 已查过的部分不再重查（RD_BYTE 时每次只多一个字节）
+		n = rd_fill(r);
+		if (n < 0)
+			return (-1);
+		if (n == 0 && r->start == r->end)
+			return (0);
+		if (n == 0)
+		{
+			line->ptr = r->buf + r->start;
+			line->len = r->end - r->start;
+			line->has_nl = 0;
+			r->start = r->end;
+			return (1);
+		}
+	}
+	line->ptr = r->buf + r->start;
+	line->len = nl - line->ptr;
+	line->has_nl = 1;
+	if (line->len > 0 && line->ptr[line->len - 1] == '\r')
+		line->len--;
+	r->start = nl + 1 - r->buf;
+	return (1);
+}
+
+/**
+ * rd_buffered
+ * ----------------
+ * 目的：
+ *   缓冲区里是否已有完整的一行（接下来的 rd_line 不会去读 fd）。
+ */
+int rd_buffered(t_reader *r)
+{
+	return (r->end > r->start
+		&& memchr(r->buf + r->start, '\n', r->end - r->start) != NULL);
+}
+
+/**
+ * rd_ready
+ * ----------------
+ * 目的：
+ *   不阻塞地判断 rd_line 能否立即返回：缓冲区里已有完整的一行，
+ *   或者 fd 当前可读（此时读一次再看）。文件结束也算“就绪”，
+ *   接下来的 rd_line 会立即返回 0。
+ */
+int rd_ready(t_reader *r)
+{
+	struct pollfd p;
+	ssize_t n;
+
+	if (rd_buffered(r))
+		return (1);
+	if (r->fd < 0)
+		return (1);
+	p.fd = r->fd;
+	p.events = POLLIN;
+	p.revents = 0;
+	if (poll(&p, 1, 0) <= 0)
+		return (0);
+	n = rd_fill(r);
+	if (n <= 0)
+		return (n == 0);
+	return (rd_buffered(r));
+}
+
+/**
+ * rd_set_stop
+ * ----------------
+ * 目的：
+ *   读 heredoc 正文期间调用（结束后以 NULL 取消）：正文属于 shell 自己，
+ *   RD_PEEK 可以一次读走多行，只要不越过结束行 line。
+ */
+void rd_set_stop(t_reader *r, const char *line)
+{
+	r->stop = line;
+	r->stop_len = line ? strlen(line) : 0;
+}
+
+/**
+ * rd_tell
+ * ----------------
+ * 目的：
+ *   RD_PREAD 读取器下一个未消费字节在文件中的位置；其他方式返回 -1。
+ */
+off_t rd_tell(t_reader *r)
+{
+	if (r->mode != RD_PREAD)
+		return (-1);
+	return (r->off - (off_t)(r->end - r->start));
+}
+
+/**
+ * rd_sync
+ * ----------------
+ * 目的：
+ *   启动可能读标准输入的命令之前，把 fd 的文件偏移设为 pos
+ *   （当前命令行之后的位置，来自 rd_tell），与 bash 相同：
+ *   子进程从下一行读起，而不是从读取器预读到的地方读起。
+ *   只对 RD_PREAD 有效，其他方式的偏移本来就没有越过当前行。
+ */
+void rd_sync(t_reader *r, off_t pos)
+{
+	if (r->mode == RD_PREAD && pos >= 0)
+		lseek(r->fd, pos, SEEK_SET);
+}
+
+/**
+ * rd_resync
+ * ----------------
+ * 目的：
+ *   命令执行完后调用：文件偏移不再是 rd_sync 设下的 pos，说明有命令读了
+ *   标准输入（如 head、cat），丢掉缓冲区，从现在的偏移继续读。
+ *
+ * 返回值：
+ *   1 缓冲区已作废（之前预读的行不能再用）；0 偏移没动
+ */
+int rd_resync(t_reader *r, off_t pos)
+{
+	off_t cur;
+
+	if (r->mode != RD_PREAD || pos < 0)
+		return (0);
+	cur = lseek(r->fd, 0, SEEK_CUR);
+	if (cur < 0 || cur == pos)
+		return (0);
+	r->start = 0;
+	r->end = 0;
+	r->off = cur;
+	return (1);
+}
+
+/**
+ * rd_stdin
+ * ----------------
+ * 目的：
+ *   标准输入的共享读取器（首次使用时建立）。heredoc、续行与批处理的主循环
+ *   都经由它读取标准输入，谁先读入缓冲区的数据都不会丢给对方。
+ *   标准输入还要留给 shell 启动的命令读取，不能读过当前行：
+ *   普通文件用 RD_PREAD（执行每行前 rd_sync），管道用 RD_PEEK，
+ *   其他（套接字等）用 RD_BYTE。终端用 RD_BLOCK：行模式的终端
+ *   每次 read 本来就停在行尾，粘贴进 heredoc 的大段文字也是一行一次。
+ */
+t_reader *rd_stdin(void)
+{
+	static t_reader in = {STDIN_FILENO, NULL, 0, 0, 0, RD_BLOCK, 0,
+		{-1, -1}, NULL, 0};
+	struct stat st;
+
+	if (in.buf)
+		return (&in);
+	if (!rd_init(&in, STDIN_FILENO, IO_BUF_SIZE))
+		return (NULL);
+	if (isatty(STDIN_FILENO) || fstat(STDIN_FILENO, &st) != 0)
+		return (&in);
+	in.mode = RD_BYTE;
+	if (S_ISFIFO(st.st_mode) && pipe2(in.peek, O_CLOEXEC) == 0)
+		in.mode = RD_PEEK;
+	else if (S_ISREG(st.st_mode))
+	{
+		in.off = lseek(STDIN_FILENO, 0, SEEK_CUR);
+		if (in.off >= 0)
+			in.mode = RD_PREAD;
+		else
+			in.off = 0;
+	}
+	return (&in);
+}
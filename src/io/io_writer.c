@@ -0,0 +1,86 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   io_writer.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 16:20:07 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 16:20:07 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+#include <errno.h>
+
+/* 把 [s, s + n) 全部写进 fd，处理短写和 EINTR。成功返回 1 */
+int io_write_all(int fd, const char *s, size_t n)
+{
+	ssize_t w;
+
+	while (n > 0)
+	{
+		w = write(fd, s, n);
+		if (w < 0 && errno == EINTR)
+			continue ;
+		if (w < 0)
+			return (0);
+		s += w;
+		n -= w;
+	}
+	return (1);
+}
+
+/**
+ * wr_init
+ * ----------------
+ * 目的：
+ *   为 fd 建立一个写入器，缓冲区大小为 cap（0 表示 IO_BUF_SIZE）。
+ *   成功返回 1，内存不足返回 0。
+ */
+int wr_init(t_writer *w, int fd, size_t cap)
+{
+	if (cap == 0)
+		cap = IO_BUF_SIZE;
+	w->fd = fd;
+	w->cap = cap;
+	w->len = 0;
+	w->buf = malloc(cap);
+	return (w->buf != NULL);
+}
+
+/* 把缓冲区里的数据写出去。成功返回 1 */
+int wr_flush(t_writer *w)
+{
+	int ok;
+
+	ok = io_write_all(w->fd, w->buf, w->len);
+	w->len = 0;
+	return (ok);
+}
+
+/**
+ * wr_put
+ * ----------------
+ * 目的：
+ *   追加 n 个字节。放不下时先写出缓冲区；
+ *   比整个缓冲区还大的数据不再经过缓冲区，直接写出。成功返回 1
+ */
+int wr_put(t_writer *w, const char *s, size_t n)
+{
+	if (w->len + n > w->cap && !wr_flush(w))
+		return (0);
+	if (n >= w->cap)
+		return (io_write_all(w->fd, s, n));
+	memcpy(w->buf + w->len, s, n);
+	w->len += n;
+	return (1);
+}
+
+/* 释放缓冲区（不会写出，需要的话先 wr_flush） */
+void wr_free(t_writer *w)
+{
+	free(w->buf);
+	w->buf = NULL;
+	w->len = 0;
+}
@@ -13,11 +13,13 @@
 #ifndef LEXER_H
 #define LEXER_H
 
-// 临时信息包，用来构造 t_lexer 节点：
+// 临时信息包，用来构造一个 token：
 // clean：去除包裹引号后的文本；
 // raw：原始片段（含引号）；
 // had_quotes：是否出现过引号；
-// quoted_single / quoted_double：是否出现过 ' / "。
+// quoted_single / quoted_double：是否出现过 ' / "；
+// needs_expand：是否含有可展开的 $（不在单引号内）；
+// start / len：该 token 在 raw_line 中的起点与长度。
 typedef struct s_token_info
 {
 	char *clean;
@@ -25,14 +27,11 @@ typedef struct s_token_info
 	int had_quotes;
 	int quoted_single;
 	int quoted_double;
+	int needs_expand;
+	int start;
+	int len;
 } t_token_info;
 
-typedef struct s_index
-{
-	size_t i;
-	size_t j;
-} t_index;
-
 typedef enum
 {
 	TOK_WORD,
@@ -45,46 +44,81 @@ typedef enum
 	TOK_REDIR_OUT, // >（写出）
 	TOK_APPEND,	   // >>
 	TOK_HEREDOC,   // <<
+	TOK_HERESTRING, // <<<
 	TOK_END,	   // EOF
 	TOK_AMP,	   // &
 	TOK_SEMI,	   // ;
 	TOK_ERROR
 } tok_type;
 
-typedef struct s_lexer
+// token 标志位（t_tokens.flags）
+#define TOKF_QUOTED_SINGLE 1 // 出现过单引号
+#define TOKF_QUOTED_DOUBLE 2 // 出现过双引号
+#define TOKF_HAD_QUOTES 4	 // 出现过任意引号
+#define TOKF_NEEDS_EXPAND 8	 // 含可展开的 $，expander 需要做变量替换
+#define TOKF_NEEDS_UNQUOTE 16 // 含引号，expander 需要去引号
+
+// 字符分类位（lex_class 的返回值），0 表示普通单词字节
+#define LEX_C_SPACE 1  // 空白
+#define LEX_C_OP 2	   // 运算符首字符 | < > ( ) & ;
+#define LEX_C_QUOTE 4  // ' 或 "
+#define LEX_C_DOLLAR 8 // $
+#define LEX_C_END 16   // '\0'
+
+// 引号上下文注解位（quote_scan 为源串的每个字节写一个）
+#define QC_SQ 1	   // 处于单引号段内（含两端引号）
+#define QC_DQ 2	   // 处于双引号段内（含两端引号）
+#define QC_DELIM 4 // 本字节就是开/闭引号
+#define QC_EXP 8   // 本字节是可展开的 '$'（不在单引号内）
+
+#define TOKENS_INIT_CAP 64
+
+// 一行的 token 序列：连续数组（struct-of-arrays），下标即 token 编号。
+// 最后一个元素总是 TOK_END 哨兵。
+// type / flags / start / len：类型、引号标志、在 raw_line 中的起点与长度；
+// raw：WORD 的原文切片，直接指向 raw_line 内部（词法结束后原地以 '\0' 封口，零拷贝）；
+// str：展开与去引号后的文本。字节未改变时与 raw 指向同一处，
+//      只有展开/去引号真正改变了内容时才在本行 arena 中分配新串；
+//      运算符 token 指向静态字面量。
+// qctx：整行的引号上下文注解（quote_scan 的结果，在本行 arena 中），
+//      第 i 个 WORD 的注解是 qctx + start[i]，expander 据此展开与去引号。
+// 数组本身跨行复用，只在容量不够时翻倍扩容。
+typedef struct s_tokens
 {
-	char *str;
-	tok_type tokentype;
-	int idx;
-	int had_quotes;
-	int quoted_by;
-	char *raw;
-	struct s_lexer *prev;
-	struct s_lexer *next;
-} t_lexer;
+	tok_type *type;
+	unsigned char *flags;
+	int *start;
+	int *len;
+	char **str;
+	char **raw;
+	unsigned char *qctx;
+	int count;
+	int cap;
+} t_tokens;
 
-t_lexer *new_node(t_token_info *info, tok_type tokentype);
-void list_add_back(t_lexer **lst, t_lexer *new);
-int add_node(t_token_info *info, tok_type tokentype,
-			 t_lexer **list);
+// parser 的游标：token 序列 + 当前下标。
+typedef struct s_cursor
+{
+	t_tokens *toks;
+	int pos;
+} t_cursor;
 
-t_lexer *clear_one(t_lexer **lst);
-void del_first(t_lexer **lst);
-void del_one(t_lexer **lst, int target);
-void clear_list(t_lexer **lst);
+int tokens_reserve(t_tokens *toks, int need);
+int add_token(t_tokens *toks, t_token_info *info, tok_type tokentype);
+void tokens_clear(t_tokens *toks);
+void tokens_free(t_tokens *toks);
 
 tok_type is_token(int c);
-int handle_token(char *str, int idx, t_lexer **list);
-int match_quotes(int i, char *str, char quote);
-
-char *remove_quotes_flag(const char *s, int *had_q,
-						 int *q_single, int *q_double);
+int handle_token(t_tokens *toks, char *str, int idx);
+int quote_scan(const char *s, unsigned char *ctx);
 
-int handle_word(char *str, int i, t_lexer **list);
+int handle_word(t_tokens *toks, char *str, int i);
 int skip_spaces(char *str, int i);
+unsigned char lex_class(int c);
+int lex_skip_plain(const char *s, int i);
 int handle_lexer(t_minishell *general);
 int is_space(char c);
 
-void print_lexer(t_lexer *lexer);
+void print_lexer(t_tokens *toks);
 
 #endif
@@ -13,122 +13,100 @@
 #include "../../include/minishell.h"
 #include "libft.h"
 
-// 作用：把临时收集到的解析信息填入新建的 `t_lexer` 节点。
-// 参数：`new` 新节点；`info` 解析期间的上下文字段。
-// 逻辑：字段对字段拷贝（索引、原始子串、去引号文本、标志等），确保节点自包含。（函数体被截断，
-// 但从文件命名与 `add_node` 使用看，这里完成初始化）
-static void	init_node_info(t_lexer *new, t_token_info *info)
+// 作用：把一个数组扩容到 new_cap 个元素（realloc 语义，失败时原数组保持不变）。
+// 参数：数组指针地址、元素大小、旧容量、新容量。
+// 逻辑：malloc 新块→拷贝旧内容→free 旧块→写回。
+static int	grow_array(void **arr, size_t elem, int old_cap, int new_cap)
 {
-	if (info)
-	{
-		new->str = info->clean;
-		new->raw = info->raw;
-		new->had_quotes = info->had_quotes;
-		new->quoted_by = 0;
-		if (info->quoted_single)
-			new->quoted_by += 1;
-		if (info->quoted_double)
-			new->quoted_by += 2;
-	}
-	else
-	{
-		new->str = NULL;
-		new->raw = NULL;
-		new->had_quotes = 0;
-		new->quoted_by = 0;
-	}
+	void	*fresh;
+
+	fresh = malloc(elem * new_cap);
+	if (!fresh)
+		return (0);
+	if (*arr)
+		ft_memcpy(fresh, *arr, elem * old_cap);
+	free(*arr);
+	*arr = fresh;
+	return (1);
 }
 
-// 作用：根据临时解析信息 info 与记号类型 tokentype，
-// 分配并构造一个完整的词法节点 t_lexer。
-// 参数：
-//     * info：词法阶段已收集好的临时信息（比如：原始子串、
-// 	去引号后的文本、引号标志、起止索引等）。
-//     * tokentype：该节点的 token 类型
-// * 实现逻辑简介：
-//     1. malloc(sizeof(t_lexer)) 分配新节点，失败返回 NULL。
-//     2. 调用 init_node_info(new, info) 把解析期信息拷入节点字段（
-// 	确保节点自包含，不依赖外部缓冲）。
-//     3. 设置 new->tokentype = tokentype。
-//     4. 使用文件静态计数器 static int idx = 0; 给节点分配自增索引：new->idx = idx++;
-//     这意味着本进程生命周期内创建的词法节点会获得全局递增的编号；清空链表不会重置该计数器
-//     5. 将双向链表指针置空：new->next = NULL; new->prev = NULL;
-//     6. 返回新节点指针。
-t_lexer	*new_node(t_token_info *info, tok_type tokentype)
+// 作用：保证 token 序列至少能容纳 need 个元素。
+// 参数：token 序列、需要的元素个数。
+// 逻辑：容量不足时按 2 倍扩容（起始 TOKENS_INIT_CAP），各列数组一起扩容；
+// 数组跨行复用，稳定后不再分配。成功返回 1，内存失败返回 0。
+int	tokens_reserve(t_tokens *toks, int need)
 {
-	t_lexer		*new;
-	static int	idx = 0;
+	int	cap;
 
-	new = malloc(sizeof(t_lexer));
-	if (!new)
-		return (NULL);
-	init_node_info(new, info);
-	if (tokentype == TOK_OR)
-		new->str = ft_strdup("||");
-	if (tokentype == TOK_AND)
-		new->str = ft_strdup("&&");
-	if (tokentype == TOK_APPEND)
-		new->str = ft_strdup(">>");
-	if (tokentype == TOK_HEREDOC)
-		new->str = ft_strdup("<<");
-	if (tokentype == TOK_REDIR_IN)
-		new->str = ft_strdup("<");
-	if (tokentype == TOK_REDIR_OUT)
-		new->str = ft_strdup(">");
-	if (tokentype == TOK_AMP)
-		new->str = ft_strdup("&");
-	if (tokentype == TOK_LPAREN)
-		new->str = ft_strdup("(");
-	if (tokentype == TOK_RPAREN)
-		new->str = ft_strdup(")");
-	if (tokentype == TOK_PIPE)
-		new->str = ft_strdup("|");
-	if (tokentype == TOK_SEMI)
-		new->str = ft_strdup(";");
-	
-	new->tokentype = tokentype;
-	new->idx = idx++;
-	new->next = NULL;
-	new->prev = NULL;
-	return (new);
+	if (need <= toks->cap)
+		return (1);
+	cap = toks->cap;
+	if (cap < TOKENS_INIT_CAP)
+		cap = TOKENS_INIT_CAP;
+	while (cap < need)
+		cap *= 2;
+	if (!grow_array((void **)&toks->type, sizeof(tok_type), toks->cap, cap)
+		|| !grow_array((void **)&toks->flags, sizeof(unsigned char),
+			toks->cap, cap)
+		|| !grow_array((void **)&toks->start, sizeof(int), toks->cap, cap)
+		|| !grow_array((void **)&toks->len, sizeof(int), toks->cap, cap)
+		|| !grow_array((void **)&toks->str, sizeof(char *), toks->cap, cap)
+		|| !grow_array((void **)&toks->raw, sizeof(char *), toks->cap, cap))
+		return (0);
+	toks->cap = cap;
+	return (1);
 }
 
-// 作用：将 `new` 追加到词法链表尾部。
-// 参数：链表头指针地址、待插入节点。
-// 逻辑：空表则置头；否则走到尾节点 `next==NULL` 处链接。
-void	list_add_back(t_lexer **lst, t_lexer *new)
+// 作用：运算符 token 的固定文本（不需要分配内存）。
+// 参数：token 类型。
+// 逻辑：按类型返回字面量；WORD / END 返回 NULL。
+static char	*token_literal(tok_type tokentype)
 {
-	t_lexer	*tmp;
+	static char	*lit[TOK_ERROR + 1] = {
+	[TOK_PIPE] = "|", [TOK_AND] = "&&", [TOK_OR] = "||",
+	[TOK_LPAREN] = "(", [TOK_RPAREN] = ")", [TOK_REDIR_IN] = "<",
+	[TOK_REDIR_OUT] = ">", [TOK_APPEND] = ">>", [TOK_HEREDOC] = "<<",
+	[TOK_HERESTRING] = "<<<", [TOK_AMP] = "&", [TOK_SEMI] = ";"};
 
-	if (!lst || !new)
-		return ;
-	tmp = *lst;
-	if (*lst == NULL)
-	{
-		*lst = new;
-		new->prev = NULL;
-		return ;
-	}
-	while (tmp->next != NULL)
-		tmp = tmp->next;
-	tmp->next = new;
-	new->prev = tmp;
-	new->next = NULL;
+	if (tokentype < 0 || tokentype > TOK_ERROR)
+		return (NULL);
+	return (lit[tokentype]);
 }
 
-// 作用：统一的“构建并追加节点”接口。
-// 参数：临时信息、token 类型、链表头地址。
-// 逻辑：`new_node(info, tokentype)`（你项目内的构造器）→失败返回 0；
-// 成功后 `list_add_back` →返回 1。
-int	add_node(t_token_info *info, tok_type tokentype, t_lexer **list)
+// 作用：统一的“构建并追加 token”接口。
+// 参数：token 序列、临时信息（可为 NULL）、token 类型。
+// 逻辑：必要时扩容→在下标 count 处逐列写入字段（文本、原文、引号标志、
+// 在 raw_line 中的偏移与长度）→count++。O(1) 均摊，无需走到链表尾部。
+// 成功返回 1，内存失败返回 0。
+int	add_token(t_tokens *toks, t_token_info *info, tok_type tokentype)
 {
-	t_lexer	*node;
+	int	i;
 
-	if (!list)
-		return (0);
-	node = new_node(info, tokentype);
-	if (!node)
+	if (!toks || !tokens_reserve(toks, toks->count + 1))
 		return (0);
-	list_add_back(list, node);
+	i = toks->count;
+	toks->type[i] = tokentype;
+	toks->flags[i] = 0;
+	toks->start[i] = 0;
+	toks->len[i] = 0;
+	toks->str[i] = token_literal(tokentype);
+	toks->raw[i] = NULL;
+	if (info)
+	{
+		if (info->clean)
+			toks->str[i] = info->clean;
+		toks->raw[i] = info->raw;
+		toks->start[i] = info->start;
+		toks->len[i] = info->len;
+		if (info->quoted_single)
+			toks->flags[i] |= TOKF_QUOTED_SINGLE;
+		if (info->quoted_double)
+			toks->flags[i] |= TOKF_QUOTED_DOUBLE;
+		if (info->had_quotes)
+			toks->flags[i] |= TOKF_HAD_QUOTES | TOKF_NEEDS_UNQUOTE;
+		if (info->needs_expand)
+			toks->flags[i] |= TOKF_NEEDS_EXPAND;
+	}
+	toks->count++;
 	return (1);
 }
@@ -12,66 +12,29 @@
 
 #include "../../include/minishell.h"
 
-// 作用：释放一个词法节点内部动态资源。
-// 参数：节点指针。
-// 逻辑：逐字段判空 `free`，再置空以防悬垂。（函数体被截断，但与同文件其他函数配合可确定职责）
-static void	free_lexer_content(t_lexer *node)
+// 作用：清空 token 序列，准备处理下一行。
+// 参数：token 序列。
+// 逻辑：只把 count 归零，O(1)；数组保留复用，字符串与引号注解属于本行的 arena，由 arena_reset 回收。
+void	tokens_clear(t_tokens *toks)
 {
-	if (!node)
+	if (!toks)
 		return ;
-	if (node->raw && node->raw == node->str)
-	{
-		free(node->raw);
-		node->raw = NULL;
-		node->str = NULL;
-	}
-	else
-	{
-		if (node->raw)
-		{
-			free(node->raw);
-			node->raw = NULL;
-		}
-		if (node->str)
-		{
-			free(node->str);
-			node->str = NULL;
-		}
-	}
+	toks->count = 0;
+	toks->qctx = NULL;
 }
 
-// 作用：释放并删除当前指向的单个词法节点（含其内部动态内存），将头指针置为 NULL。
-// 参数/逻辑：入参是链表头指针地址；判空后取出节点→free_lexer_content
-// →断开 next/prev→free(node)→*lst=NULL→返回 NULL。
-t_lexer	*clear_one(t_lexer **lst)
+// 作用：释放 token 序列的各列数组（进程退出或临时序列用完时调用）。
+// 参数：token 序列。
+// 逻辑：逐列 free 并把结构体清零。
+void	tokens_free(t_tokens *toks)
 {
-	t_lexer	*node;
-
-	if (!lst || !*lst)
-		return (NULL);
-	node = *lst;
-	free_lexer_content(node);
-	node->next = NULL;
-	node->prev = NULL;
-	free(node);
-	*lst = NULL;
-	return (NULL);
-}
-
-// 作用：清空并释放整个词法链表。
-// 参数：头指针地址。
-// 逻辑：遍历：缓存 `next` → `clear_one(lst)`（你项目中的单节点释放器）→前进；
-// 结束后头指针为 `NULL`。
-void	clear_list(t_lexer **lst)
-{
-	t_lexer	*tmp;
-
-	if (!lst || !*lst)
+	if (!toks)
 		return ;
-	while (*lst)
-	{
-		tmp = (*lst)->next;
-		clear_one(lst);
-		*lst = tmp;
-	}
+	free(toks->type);
+	free(toks->flags);
+	free(toks->start);
+	free(toks->len);
+	free(toks->str);
+	free(toks->raw);
+	ft_bzero(toks, sizeof(t_tokens));
 }
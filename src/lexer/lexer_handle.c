@@ -20,64 +20,86 @@
 int skip_spaces(char *str, int i)
 {
     int j = 0;
-    while (str[i + j] && is_space(str[i + j]))  // 确保不越界
+    while (lex_class(str[i + j]) & LEX_C_SPACE)  // '\0' 不属于空白，自然停下
         j++;
     return j;
 }
 
-// 作用：处理中断：若处于 SIGINT 状态，清空已构建的词法链表并返回“被打断”。
-// 参数：链表头地址。
-// 逻辑：检测全局信号（你项目）；如触发→`clear_list(list)`→复位→返回 1，否则 0。
-/*static int	check_sigint(t_lexer **list)
+// 作用：把所有 WORD token 变成以 '\0' 结尾的切片视图。
+// 参数：全局上下文。
+// 逻辑：单词之后的那个字节一定是空白、运算符或行尾，词法结束后已不再需要，
+// 直接原地写 '\0'，raw 即指向 raw_line 内部，无需任何拷贝。
+// 运算符 token 使用静态字面量，因此覆盖掉的运算符字节不受影响。
+static void	seal_word_slices(t_minishell *general)
 {
-	if (g_signal == SIGINT)
+	t_tokens	*toks;
+	int			i;
+
+	toks = &general->tokens;
+	i = 0;
+	while (i < toks->count)
 	{
-		clear_list(list);
-		g_signal = 0;
-		return (1);
+		if (toks->type[i] == TOK_WORD)
+		{
+			toks->raw[i] = general->raw_line + toks->start[i];
+			toks->raw[i][toks->len[i]] = '\0';
+		}
+		i++;
 	}
-	return (0);
-}*/
+}
 
-// 作用：对 `general->args` 执行整行词法拆分。
-// 参数：全局上下文（含输入字符串 `args` 与输出链表 `lexer`）。
+// 作用：对 `general->raw_line` 执行整行词法拆分。
+// 参数：全局上下文（含输入字符串 `raw_line` 与输出 token 序列 `tokens`）。
 // 实现逻辑：
-//   * 初始化索引 `i`，循环直到 `args[i]=='\0'`；
+//   * 先 `tokens_clear` 清空上一行的 token（数组复用，不重新分配）；
+//   * 用 `quote_scan` 一次性生成整行引号注解（放在 arena，挂到 tokens.qctx），
+//     有未闭合的引号直接失败；
+//   * 初始化索引 `i`，循环直到 `raw_line[i]=='\0'`；
 //   * 先 `skip_spaces`；
-//   * 若 `is_token(args[i])` 为真 → `j = handle_token(...)`；
+//   * 若 `is_token(raw_line[i])` 为真 → `j = handle_token(...)`；
 // 否则 `j = handle_word(...)`；
-//   * 若 `j < 0`（如引号错误/内存失败）→ `clear_list(&general->lexer)` 并返回 `0`（失败）；
+//   * 若 `j < 0`（如引号错误/内存失败）→ `tokens_clear` 并返回 `0`（失败）；
 //   * 否则 `i += j` 继续；
-//   * 结束返回 `1`（成功）。
+//   * 结束时追加 TOK_END 哨兵，并调用 seal_word_slices 原地封口各单词，
+//     因此 `raw_line` 必须可写，且要存活到本行执行结束；返回 `1`（成功）。
 int	handle_lexer(t_minishell *general)
 {
 	int	i;
 	int	j;
+
 	if (!general || !general->raw_line)
 		return (0);
+	tokens_clear(&general->tokens);
+	general->tokens.qctx = arena_alloc(general->arena,
+			ft_strlen(general->raw_line) + 1);
+	if (!general->tokens.qctx
+		|| quote_scan(general->raw_line, general->tokens.qctx) != 0)
+	{
+		tokens_clear(&general->tokens);
+		return (0);
+	}
 	i = 0;
 	while (general->raw_line[i])
 	{
-		/*if (check_sigint(&general->lexer))
-			return (0);*/
 		i += skip_spaces(general->raw_line, i);
 		if (general->raw_line[i] == '\0')
 			break ;
-		
 		if (is_token((unsigned char)general->raw_line[i]))
-			j = handle_token(general->raw_line, i, &general->lexer);
+			j = handle_token(&general->tokens, general->raw_line, i);
 		else
-			j = handle_word(general->raw_line, i, &general->lexer);
+			j = handle_word(&general->tokens, general->raw_line, i);
 		if (j < 0)
 		{
-			clear_list(&general->lexer);
+			tokens_clear(&general->tokens);
 			return (0);
 		}
 		i += j;
 	}
-	
-	add_node(NULL, TOK_END, &general->lexer);//把一个 “结束标记 token” (TOK_END) 添加到 general->lexer 链表末尾
+	if (!add_token(&general->tokens, NULL, TOK_END))
+	{
+		tokens_clear(&general->tokens);
+		return (0);
+	}
+	seal_word_slices(general);
 	return (1);
 }
-
-
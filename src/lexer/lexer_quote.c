@@ -0,0 +1,96 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   lexer_quote.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 11:02:15 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 11:02:15 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+// 作用：把 ctx[from..to) 标成同一个引号上下文。
+// 参数：注解数组（可为 NULL，此时什么也不写）、区间、值。
+static void	mark(unsigned char *ctx, size_t from, size_t to, unsigned char v)
+{
+	if (ctx && to > from)
+		ft_memset(ctx + from, v, to - from);
+}
+
+// 作用：扫描双引号段的内部，直到闭合的 `"` 或行尾。
+// 参数：源串、注解数组、开引号之后的下标。
+// 逻辑：段内只有 '$' 需要单独标记（QC_EXP），其余字节整段写 QC_DQ；
+// 返回闭引号的下标（未闭合时返回 '\0' 的下标）。
+static size_t	scan_double(const char *s, unsigned char *ctx, size_t i)
+{
+	size_t	run;
+
+	while (1)
+	{
+		run = strcspn(s + i, "\"$");
+		mark(ctx, i, i + run, QC_DQ);
+		i += run;
+		if (s[i] != '$')
+			return (i);
+		if (ctx)
+			ctx[i] = QC_DQ | QC_EXP;
+		i++;
+	}
+}
+
+// 作用：整行只扫一遍，给每个字节写上引号上下文注解（QC_*），供各阶段共用。
+// 参数：以 '\0' 结尾的源串；`ctx` 至少 strlen(s) + 1 字节（行尾 '\0' 也有注解 0），
+// 传 NULL 则只判断是否闭合。
+// 逻辑：引号外用 strcspn 跳到下一个 `'`/`"`/`$`；单引号段用 strchr 直接找闭引号，
+// 段内一律 QC_SQ（'$' 不展开）；双引号段见 scan_double。开/闭引号本身额外带 QC_DELIM。
+// 这是全 shell 唯一的引号状态机：补行判断（main）、分词（lexer）、
+// 展开与去引号（expander）都只读这份注解，因此对“哪里算引号内”的判断必然一致。
+// 返回：0 表示引号全部闭合；否则返回未闭合的那个引号字符。
+int	quote_scan(const char *s, unsigned char *ctx)
+{
+	size_t		i;
+	size_t		run;
+	const char	*close;
+	char		q;
+
+	i = 0;
+	while (1)
+	{
+		run = strcspn(s + i, "'\"$");
+		mark(ctx, i, i + run, 0);
+		i += run;
+		if (!s[i])
+		{
+			if (ctx)
+				ctx[i] = 0;
+			return (0);
+		}
+		if (s[i] == '$')
+		{
+			if (ctx)
+				ctx[i] = QC_EXP;
+			i++;
+			continue ;
+		}
+		q = s[i];
+		if (q == '\'')
+		{
+			close = strchr(s + i + 1, '\'');
+			run = close ? (size_t)(close - s) : i + 1 + strlen(s + i + 1);
+			mark(ctx, i + 1, run, QC_SQ);
+		}
+		else
+			run = scan_double(s, ctx, i + 1);
+		if (!s[run])
+			return ((unsigned char)q);
+		if (ctx)
+		{
+			ctx[i] = (q == '\'' ? QC_SQ : QC_DQ) | QC_DELIM;
+			ctx[run] = ctx[i];
+		}
+		i = run + 1;
+	}
+}
@@ -0,0 +1,178 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   lexer_scan.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 10:12:40 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 10:12:40 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+#include <stdint.h>
+
+#if defined(__SSE2__) && !defined(__SANITIZE_ADDRESS__)
+# include <emmintrin.h>
+# define LEX_SIMD 1
+#endif
+#if defined(LEX_SIMD) && defined(__AVX2__)
+# include <immintrin.h>
+#endif
+
+// 字符分类表：下标为无符号字节，值为 LEX_C_* 位的组合，0 表示普通单词字节。
+// 编译期常量初始化（指定初始化器），不需要运行时构建。
+static const unsigned char	g_lex_class[256] = {
+	['\0'] = LEX_C_END,
+	[' '] = LEX_C_SPACE,
+	['\t'] = LEX_C_SPACE,
+	['\n'] = LEX_C_SPACE,
+	['\v'] = LEX_C_SPACE,
+	['\f'] = LEX_C_SPACE,
+	['\r'] = LEX_C_SPACE,
+	['|'] = LEX_C_OP,
+	['<'] = LEX_C_OP,
+	['>'] = LEX_C_OP,
+	['('] = LEX_C_OP,
+	[')'] = LEX_C_OP,
+	['&'] = LEX_C_OP,
+	[';'] = LEX_C_OP,
+	['\''] = LEX_C_QUOTE,
+	['"'] = LEX_C_QUOTE,
+	['$'] = LEX_C_DOLLAR,
+};
+
+// 作用：查表得到字节 `c` 的分类位。
+// 参数：字符（按无符号字节解释）。
+unsigned char	lex_class(int c)
+{
+	return (g_lex_class[(unsigned char)c]);
+}
+
+#ifdef LEX_SIMD
+
+# ifdef __AVX2__
+
+// 作用：32 字节块中“可能是特殊字节”的位掩码（第 k 位对应第 k 个字节）。
+// 逻辑：<= ' ' 的字节（含 '\0' 与全部空白）一次饱和减法判定，
+// 其余 10 个特殊字符逐一比较。结果是候选集合，可能包含普通的控制字符，
+// 由调用方再用查表确认。
+static unsigned int	special_mask32(__m256i v)
+{
+	__m256i	hit;
+
+	hit = _mm256_cmpeq_epi8(_mm256_subs_epu8(v, _mm256_set1_epi8(' ')),
+			_mm256_setzero_si256());
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('|')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('<')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('>')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('(')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(')')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('&')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(';')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\'')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('"')));
+	hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('$')));
+	return ((unsigned int)_mm256_movemask_epi8(hit));
+}
+
+// 作用：从 p 起找到第一个候选特殊字节。
+// 逻辑：只做对齐加载——对齐块不会跨页，因此读到 '\0' 之后的几个字节也不会越界访问；
+// 首块用移位丢掉 p 之前的字节，之后每次前进 32 字节，直到掩码非零。
+static const char	*find_candidate(const char *p)
+{
+	const char		*blk;
+	unsigned int	mask;
+
+	blk = (const char *)((uintptr_t)p & ~(uintptr_t)31);
+	mask = special_mask32(_mm256_load_si256((const __m256i *)blk))
+		>> (p - blk);
+	if (mask)
+		return (p + __builtin_ctz(mask));
+	while (1)
+	{
+		blk += 32;
+		mask = special_mask32(_mm256_load_si256((const __m256i *)blk));
+		if (mask)
+			return (blk + __builtin_ctz(mask));
+	}
+}
+
+# else
+
+// 作用：16 字节块中“可能是特殊字节”的位掩码（第 k 位对应第 k 个字节）。
+// 逻辑：与 32 字节版本相同的判定方式。
+static unsigned int	special_mask16(__m128i v)
+{
+	__m128i	hit;
+
+	hit = _mm_cmpeq_epi8(_mm_subs_epu8(v, _mm_set1_epi8(' ')),
+			_mm_setzero_si128());
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('|')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('<')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('>')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('(')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8(')')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('&')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8(';')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('\'')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('"')));
+	hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('$')));
+	return ((unsigned int)_mm_movemask_epi8(hit));
+}
+
+// 作用：从 p 起找到第一个候选特殊字节（SSE2，16 字节步长）。
+// 逻辑：同 AVX2 版本，只用对齐加载，首块移位去掉 p 之前的字节。
+static const char	*find_candidate(const char *p)
+{
+	const char		*blk;
+	unsigned int	mask;
+
+	blk = (const char *)((uintptr_t)p & ~(uintptr_t)15);
+	mask = special_mask16(_mm_load_si128((const __m128i *)blk))
+		>> (p - blk);
+	if (mask)
+		return (p + __builtin_ctz(mask));
+	while (1)
+	{
+		blk += 16;
+		mask = special_mask16(_mm_load_si128((const __m128i *)blk));
+		if (mask)
+			return (blk + __builtin_ctz(mask));
+	}
+}
+
+# endif
+
+// 作用：跳过从 `i` 开始的一段普通单词字节，返回第一个非普通字节的下标。
+// 参数：以 '\0' 结尾的命令串、起点。
+// 逻辑：向量化找候选，再用分类表确认；候选若只是普通控制字符就越过继续找。
+// 由于 '\0' 一定是候选，循环必然终止。
+int	lex_skip_plain(const char *s, int i)
+{
+	const char	*p;
+
+	p = s + i;
+	while (1)
+	{
+		p = find_candidate(p);
+		if (g_lex_class[(unsigned char)*p])
+			return ((int)(p - s));
+		p++;
+	}
+}
+
+#else
+
+// 作用：跳过从 `i` 开始的一段普通单词字节（标量版本）。
+// 参数：以 '\0' 结尾的命令串、起点。
+// 逻辑：逐字节查表，直到遇到任何分类位非零的字节（'\0' 也在表中）。
+int	lex_skip_plain(const char *s, int i)
+{
+	while (!g_lex_class[(unsigned char)s[i]])
+		i++;
+	return (i);
+}
+
+#endif
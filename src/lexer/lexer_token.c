@@ -25,6 +25,10 @@ tok_type is_token(int c)
 		return (TOK_LPAREN);
 	if (c == ')')
 		return (TOK_RPAREN);
+	if (c == '&')
+		return (TOK_AMP);
+	if (c == ';')
+		return (TOK_SEMI);
 	return (0);
 }
 
@@ -38,51 +42,55 @@ static void init_token_info(t_token_info *info)
 	info->had_quotes = 0;
 	info->quoted_single = 0;
 	info->quoted_double = 0;
+	info->needs_expand = 0;
+	info->start = 0;
+	info->len = 0;
 }
 
-// 作用：处理 `<<` / `>>` 等双字符、运算符，并入链表。
-// 参数：当前已判定的单字符类型、下一个字符、临时信息、链表头。
+// 作用：处理 `<<` / `>>` 等双字符、运算符，并追加到 token 序列。
+// 参数：token 序列、当前已判定的单字符类型、下一个字符、临时信息。
 // 逻辑：若可与下一字符组成复合 token，则设定为 `HEREDOC`/`APPEND` 等，
 // 创建节点并返回消费长度；否则按单字符处理。
-static int handle_double_token(tok_type tokentype, int next_char,
-							   t_token_info *info, t_lexer **list)
+static int handle_double_token(t_tokens *toks, tok_type tokentype,
+							   int next_char, t_token_info *info)
 {
+	info->len = 2;
 	if (tokentype == TOK_REDIR_OUT && is_token(next_char) == TOK_REDIR_OUT)
 	{
 		
-		if (!add_node(info, TOK_APPEND, list))
+		if (!add_token(toks, info, TOK_APPEND))
 			return (-1);
 		return (2);
 	}
 	if (tokentype == TOK_REDIR_IN && is_token(next_char) == TOK_REDIR_IN)
 	{
 		
-		if (!add_node(info, TOK_HEREDOC, list))
+		if (!add_token(toks, info, TOK_HEREDOC))
 			return (-1);
 		return (2);
 	}
 	if (tokentype == TOK_PIPE && is_token(next_char) == TOK_PIPE)
 	{
 		
-		if (!add_node(info, TOK_OR, list))
+		if (!add_token(toks, info, TOK_OR))
 			return (-1);
 		return (2);
 	}
 	if (tokentype == TOK_AMP && is_token(next_char) == TOK_AMP)
 	{
 		
-		if (!add_node(info, TOK_AND, list))
+		if (!add_token(toks, info, TOK_AND))
 			return (-1);
 		return (2);
 	}
 	return (0);
 }
 
-// 作用：在 `str[i]` 解析一个符号类 token 并加入链表。
-// 参数：命令串、起始下标、链表头。
-// 逻辑：调用 `is_token` 与 `handle_double_token` 决定 1/2 字符长度，
-// 填充 `t_token_info`→`add_node`→返回消费的字符数；失败返回负值。
-int handle_token(char *str, int i, t_lexer **list)
+// 作用：在 `str[i]` 解析一个符号类 token 并追加到 token 序列。
+// 参数：token 序列、命令串、起始下标。
+// 逻辑：先认三字符的 `<<<`，再调用 `is_token` 与 `handle_double_token` 决定 1/2 字符长度，
+// 填充 `t_token_info`→`add_token`→返回消费的字符数；失败返回负值。
+int handle_token(t_tokens *toks, char *str, int i)
 {
 	tok_type tokentype;
 	int next_char;
@@ -90,38 +98,25 @@ int handle_token(char *str, int i, t_lexer **list)
 	int res;
 
 	init_token_info(&info);
+	info.start = i;
 	tokentype = is_token((unsigned char)str[i]);
 	next_char = (unsigned char)str[i + 1];
-	res = handle_double_token(tokentype, next_char, &info, list);
+	if (str[i] == '<' && next_char == '<' && str[i + 2] == '<')
+	{
+		info.len = 3;
+		if (!add_token(toks, &info, TOK_HERESTRING))
+			return (-1);
+		return (3);
+	}
+	res = handle_double_token(toks, tokentype, next_char, &info);
 	if (res != 0)
 		return (res);
 	if (tokentype)
 	{
-		if (!add_node(&info, tokentype, list))
+		info.len = 1;
+		if (!add_token(toks, &info, tokentype))
 			return (-1);
 		return (1);
 	}
 	return (0);
 }
-
-// 作用：匹配从 `i` 开始的一段**完整引号**并返回长度（未闭合返回 `-1`）。
-// 参数：起点、源串、引号字符 `'` 或 `"`。
-// 逻辑：从位置 i 开始：若 str[i] 不是目标引号，返回 0；若是，则向后扫描直到遇到同类闭合引号，
-// 找到则返回包含首尾引号在内的总长度，未找到闭合引号返回 -1。
-int match_quotes(int i, char *str, char quote)
-{
-	int j;
-
-	j = 0;
-	if (str[i + j] == quote)
-	{
-		j++;
-		while (str[i + j] != quote && str[i + j])
-			j++;
-		if (str[i + j] == quote)
-			j++;
-		else
-			return (-1);
-	}
-	return (j);
-}
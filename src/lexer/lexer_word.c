@@ -15,110 +15,78 @@
 
 // 作用：是否为空白字符。
 // 参数：`c`。
-// 逻辑：对照空格/制表符等返回 1/0。
+// 逻辑：查字符分类表（空格/制表符等）返回 1/0。
 int is_space(char c)
 {
-	return (c == ' ' || (c >= 9 && c <= 13));
+	return ((lex_class(c) & LEX_C_SPACE) != 0);
 }
 
 // 作用：计算从 `start_i` 开始的“单词”长度（引号内允许包含空白和符号）。
-// 参数：命令串、起点。
-// 逻辑：线性前进，遇到分隔符（空白/管道/重定向）停止；遇到 `'`/`"`
-// 则调用 `match_quotes` 把整段引号一起计入；若引号未闭合返回负值。
-static int calc_word_len(char *str, int start_i)
+// 参数：命令串、整行引号注解、起点、引号标志输出位（TOKF_*）。
+// 逻辑：用 lex_skip_plain 一次跳过整段普通字节（向量化/查表），
+// 停下的字节若在注解中是开引号（QC_DELIM），整段引号一起计入并记录到 `flags`，
+// 闭引号就是下一个同类引号（与 quote_scan 的规则相同，注解已保证它存在），
+// 双引号段内若有 `$` 还要记 TOKF_NEEDS_EXPAND；
+// 否则空白/运算符/行尾结束单词，`$` 属于单词本身（记 TOKF_NEEDS_EXPAND），越过继续。
+static int calc_word_len(char *str, const unsigned char *ctx, int start_i,
+						 unsigned char *flags)
 {
 	int j;
-	int q_len;
+	int close;
+	unsigned char cls;
 
-	j = 0;
-	while (str[start_i + j] && !(is_token((unsigned char)str[start_i + j])))
+	j = start_i;
+	while (1)
 	{
-		q_len = match_quotes(start_i + j, str, 34);
-		if (q_len == -1)
-			return (-1);
-		j += q_len;
-		q_len = match_quotes(start_i + j, str, 39);
-		if (q_len == -1)
-			return (-1);
-		j += q_len;
-		if (!str[start_i + j] || is_space(str[start_i + j]))
+		j = lex_skip_plain(str, j);
+		if (ctx[j] & QC_DELIM)
+		{
+			close = (int)(strchr(str + j + 1, str[j]) - str);
+			if (ctx[j] & QC_SQ)
+				*flags |= TOKF_QUOTED_SINGLE | TOKF_HAD_QUOTES;
+			else
+			{
+				*flags |= TOKF_QUOTED_DOUBLE | TOKF_HAD_QUOTES;
+				if (ft_memchr(str + j + 1, '$', close - j - 1))
+					*flags |= TOKF_NEEDS_EXPAND;
+			}
+			j = close + 1;
+			continue ;
+		}
+		cls = lex_class(str[j]);
+		if (cls & (LEX_C_END | LEX_C_SPACE | LEX_C_OP))
 			break;
-		else if (str[start_i + j] == 34 || str[start_i + j] == 39)
-			continue;
-		else
-			j++;
+		if (cls & LEX_C_DOLLAR)
+			*flags |= TOKF_NEEDS_EXPAND;
+		j++;
 	}
-	return (j);
-}
-
-// 作用：对提取出的原始子串做**引号处理与属性标记**，并填入 `info`。
-// 参数：`substr` 截取的原文；`info` 临时节点信息。
-// 逻辑：调用 `remove_quotes_flag`，拿到去壳文本与“出现过单/双引号”的标志，记录到 `info`；
-// 失败时清理并返回负值。
-static int process_word_data(char *substr, t_token_info *info)
-{
-	char *clean;
-
-	clean = NULL;
-	clean = remove_quotes_flag(substr, &info->had_quotes, &info->quoted_single,
-							   &info->quoted_double);
-	if (!clean)
-	{
-		info->raw = NULL;
-		info->clean = substr;
-		info->had_quotes = 0;
-		info->quoted_single = 0;
-		info->quoted_double = 0;
-	}
-	else
-	{
-		info->raw = substr;
-		info->clean = clean;
-	}
-	return (1);
+	return (j - start_i);
 }
 
-// 作用：根据 `info` 构造 `WORD` 节点并追加到链表。
-// 参数：`info`、链表头地址。
-// 逻辑：调用 `add_node(info, WORD, list)`；根据返回值判断是否成功，失败回滚需要的内存。
-static int finalize_word_node(t_token_info *info, t_lexer **list)
-{
-	if (!add_node(info, TOK_WORD, list))
-	{
-		if (info->raw)
-			free(info->raw);
-		if (info->clean)// 把else if 修改成if
-			free(info->clean);
-		return (-1);
-	}
-	return (1);
-}
-
-// 作用：在 `str[i]` 解析**一个单词 token**并进链表。
-// 参数：命令串、起点、链表头。
-// 逻辑：先用 calc_word_len(str, i) 计算从 i 起一个“单词”的长度
-// （遇引号用 match_quotes 整段跳过，未闭合返回 -1）；然后 ft_substr 取片段，
-// 调用 remove_quotes_flag 去掉外层引号并记录标志，
-// 填充 t_token_info，用 add_node(info, WORD, list) 追加到链表；
-// 成功返回消费长度，出错清理并返回负值。
-int handle_word(char *str, int i, t_lexer **list)
+// 作用：在 `str[i]` 解析**一个单词 token**并追加到 token 序列。
+// 参数：token 序列、命令串、起点。
+// 逻辑：先用 calc_word_len 按整行引号注解（toks->qctx）计算从 i 起一个“单词”的长度与引号标志；
+// 不拷贝任何字节：token 只记录 (start, len, 引号标志) 这一“切片”，
+// 文本在整行词法结束后由 handle_lexer 原地封口，去引号/展开留给 expander 按需进行。
+// 成功返回消费长度，出错返回负值。
+int handle_word(t_tokens *toks, char *str, int i)
 {
 	int j;
-	char *substr;
+	unsigned char flags;
 	t_token_info info;
 
-	j = 0;
-	substr = NULL;
-	j = calc_word_len(str, i);
-	if (j < 0)
-		return (-1);
+	flags = 0;
+	j = calc_word_len(str, toks->qctx, i, &flags);
 	if (j == 0)
 		return (0);
-	substr = ft_substr(str, i, j);
-	if (!substr)
-		return (-1);
-	process_word_data(substr, &info);
-	if (finalize_word_node(&info, list) < 0)
+	ft_bzero(&info, sizeof(info));
+	info.start = i;
+	info.len = j;
+	info.quoted_single = (flags & TOKF_QUOTED_SINGLE) != 0;
+	info.quoted_double = (flags & TOKF_QUOTED_DOUBLE) != 0;
+	info.had_quotes = (flags & TOKF_HAD_QUOTES) != 0;
+	info.needs_expand = (flags & TOKF_NEEDS_EXPAND) != 0;
+	if (!add_token(toks, &info, TOK_WORD))
 		return (-1);
 	return (j);
 }
@@ -1,23 +1,17 @@
 #include "../../include/minishell.h"
 
-void print_lexer(t_lexer *lexer)
+void print_lexer(t_tokens *toks)
 {
-    t_lexer *tmp = lexer;
-    
     int i = 0;
 
-    while (tmp && tmp->tokentype != TOK_END)
+    while (i < toks->count && toks->type[i] != TOK_END)
     {
-        if (!tmp->str)
-        {
-            printf("[ERROR] Node %d has NULL str\n", i);
-        }
+        if (toks->str[i])
+            printf("%s\n", toks->str[i]);
+        else if (toks->raw[i])
+            printf("%s\n", toks->raw[i]); // 尚未展开的单词：打印原文切片
         else
-        {
-            printf("%s\n", tmp->str);
-        }
-
-        tmp = tmp->next;
+            printf("[ERROR] Node %d has NULL str\n", i);
         i++;
     }
-}
\ No newline at end of file
+}
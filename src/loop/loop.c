@@ -0,0 +1,144 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   loop.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 17:02:44 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 17:02:44 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+// 一行执行完毕：打印调试统计、累计分配计数，回收本行的 token 与 arena
+static void line_done(t_minishell *minishell)
+{
+    if (minishell->debug)
+    {
+        arena_report(minishell->arena);
+        fprintf(stderr, "[expand] skipped=%d expanded=%d\n",
+                minishell->exp_skipped, minishell->exp_expanded);
+    }
+    stats_add(STC_ALLOCS, minishell->arena->n_allocs);
+    stats_add(STC_ALLOC_BYTES, minishell->arena->n_bytes);
+    // 非交互模式没有提示符前的报告，结束的后台作业在这里清理
+    if (!minishell->interactive)
+        jobs_prune(&minishell->jobs);
+    minishell->exp_skipped = 0;
+    minishell->exp_expanded = 0;
+    tokens_clear(&minishell->tokens);
+    arena_reset(minishell->arena);
+}
+
+// 对当前行做词法分析（记入 lex 的延迟直方图，跟踪时记一段 lex），成功返回非 0
+int lex_line(t_minishell *minishell)
+{
+    uint64_t t = stats_now();
+    int ok;
+
+    ok = handle_lexer(minishell);
+    stats_time(STH_LEX, t);
+    trace_span("lex", t, "tokens", minishell->tokens.count);
+    return ok;
+}
+
+// 对已经词法分析过的当前行做展开与解析，返回 AST（语法错误时为 NULL）
+ast *parse_line(t_minishell *minishell)
+{
+    uint64_t t = stats_now();
+    ast *root;
+
+    //=== expander 阶段 ===
+    expander_list(minishell, &minishell->tokens);
+    stats_time(STH_EXPAND, t);
+    trace_span("expand", t, "tokens", minishell->tokens.count);
+    // === Parser 阶段 ===
+    t = stats_now();
+    t_cursor cursor = {&minishell->tokens, 0};
+    root = parse_cmdline(&cursor, minishell);
+    stats_time(STH_PARSE, t);
+    trace_span("parse", t, NULL, 0);
+    return root;
+}
+
+// 执行解析好的一行（root 可以为 NULL），然后回收本行内存，返回退出码
+int run_parsed(t_minishell *minishell, ast *root)
+{
+    if (root)
+    {
+        uint64_t t = trace_now();
+        // 保存退出码
+        minishell->last_exit_status = exec_ast(root, minishell->env, minishell);
+        trace_span("exec", t, "status", minishell->last_exit_status);
+        free_ast(root);
+    }
+    // === 清理内存 ===
+    line_done(minishell);
+    return minishell->last_exit_status;
+}
+
+/**
+ * run_line
+ * ----------------
+ * 目的：
+ *   执行一整行命令：词法分析 → 展开 → 解析 → 执行，
+ *   结束后一次性回收本行的 token 与 arena。交互模式、脚本与 -c 共用。
+ *
+ * 参数：
+ *   - line : 要执行的一行，必须可写（lexer 原地封口各单词），
+ *            并且存活到本函数返回；由调用者管理
+ *
+ * 返回值：
+ *   - 本行的退出码（同时记录在 last_exit_status）
+ */
+int run_line(t_minishell *minishell, char *line)
+{
+    minishell->raw_line = line;
+    // === Lexer 阶段 ===
+    if (!lex_line(minishell))
+    {
+        fprintf(stderr, "tokenize failed\n");
+        arena_reset(minishell->arena);
+        return minishell->last_exit_status;
+    }
+    return run_parsed(minishell, parse_line(minishell));
+}
+
+// 整行注释（第一个非空白字符是 '#'，包括 #! 行）与空行不执行
+int loop_skip_line(const char *s)
+{
+    while (*s == ' ' || *s == '\t')
+        s++;
+    return (*s == '\0' || *s == '#');
+}
+
+/**
+ * loop_more_line
+ * ----------------
+ * 目的：
+ *   解析器需要续行时（行尾是 '|'）取下一行。
+ *   脚本 / -c / 批处理模式从当前输入里取（不显示 prompt），
+ *   交互模式用 readline 显示 prompt。
+ *
+ * 返回值：
+ *   - 可写、存活到本行结束的字符串（在 arena 或脚本缓冲区里，调用者不必释放）
+ *   - 输入结束时返回 NULL
+ */
+char *loop_more_line(t_minishell *minishell, const char *prompt)
+{
+    char *buf;
+    char *line;
+
+    if (minishell->in && minishell->in->fd < 0)
+        return script_next_line(minishell->in);
+    if (minishell->batch)
+        return batch_read_line(minishell->batch, minishell->arena);
+    buf = readline(prompt);
+    if (!buf)
+        return NULL;
+    line = arena_strdup(minishell->arena, buf);
+    free(buf);
+    return line;
+}
@@ -0,0 +1,86 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   loop.h                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 17:02:44 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 17:02:44 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef LOOP_H
+#define LOOP_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+/* 批处理模式最多提前读入、预处理的行数 */
+#define BATCH_LOOKAHEAD 8
+
+/* 预读行的处理进度 */
+typedef enum e_batch_state
+{
+	BATCH_LEXED,	// 只做了词法分析，展开与解析留到执行时
+	BATCH_PARSED,	// 已展开并解析，root 即 AST
+	BATCH_BAD,		// 词法分析失败（执行到它时再报错）
+}	t_batch_state;
+
+/**
+ * s_batch_ent
+ * ----------------
+ * 一条预读的命令行。每条有自己的 arena 与 token 序列，
+ * 执行时与 t_minishell 中的“当前行”整体交换。
+ * - blocks : 这一行还没解析，但解析时要继续从输入读取（heredoc 正文、
+ *            行尾的 '|'），在它解析完之前不能再往后预读
+ * - pos    : 输入是普通文件时，这一行（连同它读走的续行）之后在文件中的位置，
+ *            执行它之前把标准输入的偏移设到这里（见 rd_sync）；否则为 -1
+ * - no_stdin : 已解析，并且其中没有命令会读 shell 的标准输入
+ *              （输入重定向、heredoc、管道的后续阶段、后台命令、不读输入的内建），
+ *              输入是管道时只有这样的行后面才能继续预读
+ */
+typedef struct s_batch_ent
+{
+	char *line;
+	t_arena *arena;
+	t_tokens tokens;
+	ast *root;
+	t_batch_state state;
+	int blocks;
+	off_t pos;
+	int no_stdin;
+}	t_batch_ent;
+
+/**
+ * s_batch
+ * ----------------
+ * 标准输入不是终端时的批处理前端：ring 是按输入顺序排列的预读行
+ * （从 head 开始的 count 条），eof 表示输入已读完，
+ * blocked 表示队尾那条在解析前不能继续预读（见 blocks）。
+ */
+typedef struct s_batch
+{
+	t_reader *in;
+	t_batch_ent ring[BATCH_LOOKAHEAD];
+	int head;
+	int count;
+	int eof;
+	int blocked;
+}	t_batch;
+
+int run_line(t_minishell *minishell, char *line);
+int lex_line(t_minishell *minishell);
+ast *parse_line(t_minishell *minishell);
+int run_parsed(t_minishell *minishell, ast *root);
+int loop_skip_line(const char *s);
+char *loop_more_line(t_minishell *minishell, const char *prompt);
+char *script_next_line(t_reader *in);
+int run_buffer(t_minishell *minishell, char *buf, size_t len);
+int run_string(t_minishell *minishell, const char *cmd);
+int run_script(t_minishell *minishell, const char *path);
+int run_batch(t_minishell *minishell);
+void batch_prefetch(t_minishell *minishell);
+char *batch_read_line(t_batch *b, t_arena *arena);
+
+#endif
@@ -0,0 +1,355 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   loop_batch.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 18:11:26 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 18:11:26 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+/**
+ * batch_read_line
+ * ----------------
+ * 目的：
+ *   从批处理输入读一条完整的命令行，拷进 arena（读取器的缓冲区
+ *   下次读入时会挪动，视图不能留到执行时）。引号没闭合时连同换行符
+ *   把后续各行并进来。输入结束返回 NULL。
+ */
+char *batch_read_line(t_batch *b, t_arena *arena)
+{
+    t_line l;
+    char *line;
+    char *joined;
+    size_t len;
+
+    if (rd_line(b->in, &l) <= 0)
+        return NULL;
+    line = arena_strndup(arena, l.ptr, l.len);
+    while (line && quote_scan(line, NULL) != 0 && rd_line(b->in, &l) > 0)
+    {
+        len = strlen(line);
+        joined = arena_alloc(arena, len + 1 + l.len + 1);
+        if (!joined)
+            return NULL;
+        memcpy(joined, line, len);
+        joined[len] = '\n';
+        memcpy(joined + len + 1, l.ptr, l.len);
+        joined[len + 1 + l.len] = '\0';
+        line = joined;
+    }
+    return line;
+}
+
+// 交换 shell 的“当前行”（arena、token 序列、原始行）与 e 中保存的那一份；
+// 再调用一次即换回来
+static void ctx_swap(t_minishell *minishell, t_batch_ent *e)
+{
+    t_arena *arena;
+    t_tokens tokens;
+    char *line;
+
+    arena = minishell->arena;
+    minishell->arena = e->arena;
+    e->arena = arena;
+    tokens = minishell->tokens;
+    minishell->tokens = e->tokens;
+    e->tokens = tokens;
+    line = minishell->raw_line;
+    minishell->raw_line = e->line;
+    e->line = line;
+}
+
+// 命令之间的分隔符：| && || ; &
+static int is_sep(tok_type t)
+{
+    return (t == TOK_PIPE || t == TOK_AND || t == TOK_OR || t == TOK_SEMI
+        || t == TOK_AMP);
+}
+
+// 预解析只对不会出错的行进行：可能有语法错误的行（括号、
+// 不成对的分隔符与重定向）提前解析会让报错跑到前面命令的输出之前；
+// heredoc 要继续读输入；here-string 的 word 在解析时就展开，取决于
+// 前面命令执行后的变量与 $?。这些都留到执行时。
+// 其余单词里的 $ 本来就推迟到执行时展开，不影响预解析
+static int can_preparse(t_tokens *toks)
+{
+    tok_type prev;
+    tok_type t;
+    int i;
+
+    prev = TOK_SEMI;
+    i = 0;
+    while (i < toks->count && toks->type[i] != TOK_END)
+    {
+        t = toks->type[i];
+        if (t == TOK_WORD && prev == TOK_HERESTRING
+            && (toks->flags[i] & TOKF_NEEDS_EXPAND))
+            return 0;
+        if (is_sep(t) && prev != TOK_WORD)
+            return 0;
+        if (t == TOK_REDIR_IN || t == TOK_REDIR_OUT || t == TOK_APPEND
+            || t == TOK_HERESTRING)
+        {
+            if (prev != TOK_WORD && !is_sep(prev))
+                return 0;
+        }
+        else if (t != TOK_WORD && !is_sep(t))
+            return 0;
+        prev = t;
+        i++;
+    }
+    return (prev == TOK_WORD || ((prev == TOK_SEMI || prev == TOK_AMP) && i > 0));
+}
+
+// 解析时还要继续从输入读取：有 heredoc，或者行尾是 '|'（续行）
+static int reads_more(t_tokens *toks)
+{
+    int i;
+
+    i = 0;
+    while (i < toks->count)
+    {
+        if (toks->type[i] == TOK_HEREDOC)
+            return 1;
+        i++;
+    }
+    return toks->count >= 2 && toks->type[toks->count - 2] == TOK_PIPE;
+}
+
+// 命令的标准输入是否可能是 shell 自己的标准输入（保守：拿不准的都算）。
+// 管道只看第一个阶段；后台命令的标准输入是 /dev/null；
+// 有输入重定向或 heredoc 的命令读不到它；内建命令里只有 parallel 读标准输入
+static int reads_stdin(ast *n)
+{
+    t_redir *r;
+
+    if (!n || n->type == NODE_BACKGROUND)
+        return 0;
+    if (n->type == NODE_PIPE || n->type == NODE_TIME)
+        return reads_stdin(n->left);
+    if (n->type == NODE_SUBSHELL)
+        return reads_stdin(n->sub);
+    if (n->type != NODE_CMD)
+        return (reads_stdin(n->left) || reads_stdin(n->right));
+    for (r = n->redir; r; r = r->next)
+        if (r->type == REDIR_INPUT || r->type == HEREDOC)
+            return 0;
+    if (!n->argv || !n->argv[0])
+        return 0;
+    if (n->argq && n->argq[0]) // 命令名执行时才展开，不知道是什么
+        return 1;
+    return (!is_builtin(n->argv[0]) || strcmp(n->argv[0], "parallel") == 0);
+}
+
+// 在当前行已换成 e 的前提下做词法分析，能预解析的就顺带展开、解析
+static void preprocess(t_minishell *minishell, t_batch *b, t_batch_ent *e)
+{
+    e->root = NULL;
+    e->blocks = 0;
+    e->no_stdin = 0;
+    if (!lex_line(minishell))
+    {
+        e->state = BATCH_BAD;
+        return;
+    }
+    e->state = BATCH_LEXED;
+    if (!can_preparse(&minishell->tokens))
+    {
+        e->blocks = reads_more(&minishell->tokens);
+        b->blocked = e->blocks;
+        return;
+    }
+    e->root = parse_line(minishell);
+    e->state = BATCH_PARSED;
+    e->no_stdin = !reads_stdin(e->root);
+}
+
+// 读入一行放到队尾并预处理。空行与注释直接丢弃；输入结束时置 eof
+static void batch_load(t_minishell *minishell, t_batch *b)
+{
+    t_batch_ent *e;
+    uint64_t t;
+    char *line;
+
+    e = &b->ring[(b->head + b->count) % BATCH_LOOKAHEAD];
+    t = trace_now();
+    line = batch_read_line(b, e->arena);
+    trace_span("read", t, NULL, 0);
+    if (!line)
+    {
+        b->eof = 1;
+        return;
+    }
+    if (loop_skip_line(line))
+    {
+        arena_reset(e->arena);
+        return;
+    }
+    e->line = line;
+    e->pos = rd_tell(b->in);
+    ctx_swap(minishell, e);
+    preprocess(minishell, b, e);
+    ctx_swap(minishell, e);
+    b->count++;
+}
+
+// 输入是管道时能否再预读一行：队列里（含正在执行的队首）每一行都
+// 不会读 shell 的标准输入，否则下一行之后的数据可能属于它们。
+// 普通文件总是可以：预读用 pread，命令读了输入时由 batch_drop 作废
+static int can_prefetch(t_batch *b)
+{
+    int i;
+
+    if (b->in->mode == RD_PREAD)
+        return 1;
+    if (b->in->mode != RD_PEEK)
+        return 0;
+    i = 0;
+    while (i < b->count)
+    {
+        if (!b->ring[(b->head + i) % BATCH_LOOKAHEAD].no_stdin)
+            return 0;
+        i++;
+    }
+    return 1;
+}
+
+/**
+ * batch_prefetch
+ * ----------------
+ * 目的：
+ *   在外部命令运行期间（spawn 之后、waitpid 之前）调用：把已经到达的
+ *   后续行提前读入、词法分析，能预解析的顺带解析，让前端的开销藏在
+ *   子进程的运行时间里。只处理不会阻塞就能拿到的输入。
+ *   fork 出来的子进程（disposable）不做，输入只归 shell 本身。
+ *   输入是管道时，只在正在执行和已经排队的行都不会读 shell 的标准输入时
+ *   预读（见 can_prefetch），而且每次只读到行尾（RD_PEEK），不会抢走属于命令的数据。
+ *   普通文件用 pread 预读，不移动文件偏移；命令读走了输入时预读的行作废
+ *   （见 batch_drop）。
+ */
+void batch_prefetch(t_minishell *minishell)
+{
+    t_batch *b;
+
+    b = minishell->batch;
+    if (!b || minishell->disposable)
+        return;
+    while (!b->eof && !b->blocked && b->count < BATCH_LOOKAHEAD
+           && can_prefetch(b) && rd_ready(b->in))
+        batch_load(minishell, b);
+}
+
+// 刚执行的命令读了标准输入（文件偏移变了）：队首之后预读的行都不再是
+// 接下来的输入，连同预解析时打开的 here-string 一起丢掉，从新的偏移重新读
+static void batch_drop(t_batch *b)
+{
+    t_batch_ent *e;
+    int i;
+
+    i = 1;
+    while (i < b->count)
+    {
+        e = &b->ring[(b->head + i) % BATCH_LOOKAHEAD];
+        if (e->state == BATCH_PARSED)
+            free_ast(e->root);
+        e->root = NULL;
+        tokens_clear(&e->tokens);
+        arena_reset(e->arena);
+        i++;
+    }
+    if (b->count > 1)
+        b->count = 1;
+    b->blocked = 0;
+    b->eof = 0;
+}
+
+// 执行队首的一行：换成它的上下文，按预处理的进度补齐剩下的阶段
+static void run_entry(t_minishell *minishell, t_batch *b, t_batch_ent *e)
+{
+    ast *root;
+
+    ctx_swap(minishell, e);
+    if (e->state == BATCH_BAD)
+    {
+        fprintf(stderr, "tokenize failed\n");
+        tokens_clear(&minishell->tokens);
+        arena_reset(minishell->arena);
+    }
+    else
+    {
+        root = e->root;
+        if (e->state == BATCH_LEXED)
+            root = parse_line(minishell);
+        // 解析完成，它要读的输入已经读完，可以继续往后预读
+        if (e->blocks)
+        {
+            b->blocked = 0;
+            e->pos = rd_tell(b->in);
+        }
+        // 执行的命令可能读标准输入：让它从这一行之后读起；
+        // 它读走了输入的话，shell 从它停下的地方继续
+        rd_sync(b->in, e->pos);
+        run_parsed(minishell, root);
+        if (rd_resync(b->in, e->pos))
+            batch_drop(b);
+    }
+    ctx_swap(minishell, e);
+}
+
+/**
+ * run_batch
+ * ----------------
+ * 目的：
+ *   标准输入不是终端时的主循环：不用 readline，不显示提示符，
+ *   用标准输入的共享读取器取行（不会读走命令要读的输入，见 rd_stdin）；
+ *   执行的同时由 batch_prefetch 预处理后续行。
+ *
+ * 返回值：
+ *   - 最后一条命令的退出码
+ */
+int run_batch(t_minishell *minishell)
+{
+    t_batch b;
+    int i;
+
+    ft_bzero(&b, sizeof(b));
+    b.in = rd_stdin();
+    i = 0;
+    while (i < BATCH_LOOKAHEAD)
+    {
+        b.ring[i].arena = arena_new();
+        if (!b.ring[i].arena)
+            b.eof = 1;
+        i++;
+    }
+    minishell->in = b.in;
+    minishell->batch = &b;
+    // 队列空了才读下一行；执行中途 batch_drop 可能清掉 eof，所以统一在一个循环里
+    while (b.in && (b.count > 0 || !b.eof))
+    {
+        if (b.count == 0)
+            batch_load(minishell, &b);
+        if (b.count == 0)
+            continue ;
+        run_entry(minishell, &b, &b.ring[b.head]);
+        b.head = (b.head + 1) % BATCH_LOOKAHEAD;
+        b.count--;
+    }
+    minishell->batch = NULL;
+    minishell->in = NULL;
+    i = 0;
+    while (i < BATCH_LOOKAHEAD)
+    {
+        tokens_free(&b.ring[i].tokens);
+        arena_destroy(b.ring[i].arena);
+        i++;
+    }
+    if (b.in)
+        rd_free(b.in);
+    return minishell->last_exit_status;
+}
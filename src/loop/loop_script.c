@@ -0,0 +1,213 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   loop_script.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 17:02:44 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 17:02:44 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+
+/**
+ * script_next_line
+ * ----------------
+ * 目的：
+ *   从内存读取器里取下一条命令行，原地把行尾改成 '\0'，不拷贝。
+ *   引号没有闭合时，把后续各行（连同换行符）并进来，与 bash 读脚本时一致。
+ *
+ * 前提：
+ *   缓冲区可写，并且最后一个字节之后还有一个可写字节（见 run_script），
+ *   这样没有换行符结尾的最后一行也能封口。
+ *
+ * 返回值：
+ *   - 指向缓冲区内部的一行；没有更多输入时返回 NULL
+ */
+char *script_next_line(t_reader *in)
+{
+    t_line l;
+    char *line;
+    size_t len;
+    char saved;
+
+    if (rd_line(in, &l) <= 0)
+        return NULL;
+    line = (char *)l.ptr;
+    len = l.len;
+    saved = line[len];
+    line[len] = '\0';
+    while (quote_scan(line, NULL) != 0 && rd_line(in, &l) > 0)
+    {
+        line[len] = saved;
+        len = l.ptr + l.len - line;
+        saved = line[len];
+        line[len] = '\0';
+    }
+    return line;
+}
+
+/**
+ * run_buffer
+ * ----------------
+ * 目的：
+ *   逐行执行一段内存里的脚本（buf 可写，buf[len] 可写）。
+ *   执行期间它就是 shell 的输入：heredoc 正文与 '|' 续行都从这里读取。
+ *
+ * 返回值：
+ *   - 最后一条命令的退出码
+ */
+int run_buffer(t_minishell *minishell, char *buf, size_t len)
+{
+    t_reader in;
+    t_reader *saved;
+    char *line;
+
+    rd_init_mem(&in, buf, len);
+    saved = minishell->in;
+    minishell->in = &in;
+    while ((line = script_next_line(&in)))
+    {
+        if (!loop_skip_line(line))
+            run_line(minishell, line);
+    }
+    minishell->in = saved;
+    return minishell->last_exit_status;
+}
+
+// -c 模式：命令串拷贝一份（需要可写，且带结尾的 '\0'）后按脚本执行
+int run_string(t_minishell *minishell, const char *cmd)
+{
+    size_t len = strlen(cmd);
+    char *buf = malloc(len + 1);
+    int status;
+
+    if (!buf)
+        return (perror("malloc"), 1);
+    memcpy(buf, cmd, len + 1);
+    status = run_buffer(minishell, buf, len);
+    free(buf);
+    return status;
+}
+
+// 不能映射的输入（管道、/dev/stdin 等）：整个读进堆上的缓冲区，末尾补 '\0'
+static char *read_all(int fd, size_t *len)
+{
+    size_t cap = IO_BUF_SIZE;
+    char *buf = malloc(cap);
+    char *grown;
+    ssize_t n;
+
+    *len = 0;
+    while (buf)
+    {
+        if (*len + 1 >= cap)
+        {
+            grown = realloc(buf, cap * 2);
+            if (!grown)
+                break;
+            buf = grown;
+            cap *= 2;
+        }
+        n = read(fd, buf + *len, cap - *len - 1);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+        {
+            if (n < 0)
+                break;
+            buf[*len] = '\0';
+            return buf;
+        }
+        *len += n;
+    }
+    free(buf);
+    return NULL;
+}
+
+/**
+ * map_script
+ * ----------------
+ * 目的：
+ *   把普通文件私有映射进来（MAP_PRIVATE + 可写：lexer 原地写 '\0'
+ *   只会复制被改动的页，不会写回文件）。
+ *   映射长度不是页大小的整数倍时，文件末尾之后到页尾都是 0，
+ *   正好给最后一行当结尾；恰好整页且不以换行结尾时没有这个字节，返回 NULL 走 read_all。
+ */
+static char *map_script(int fd, size_t size)
+{
+    long page = sysconf(_SC_PAGESIZE);
+    char *map;
+
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+        return NULL;
+    if (page > 0 && size % page == 0 && map[size - 1] != '\n')
+    {
+        munmap(map, size);
+        return NULL;
+    }
+    return map;
+}
+
+// 脚本打不开：与 bash 相同，不存在返回 127，其余 126
+static int script_error(const char *path, int err)
+{
+    fprintf(stderr, "minishell: %s: %s\n", path, strerror(err));
+    return (err == ENOENT) ? 127 : 126;
+}
+
+/**
+ * run_script
+ * ----------------
+ * 目的：
+ *   非交互地执行脚本文件：不初始化 readline、不记历史、不计算提示符，
+ *   普通文件直接 mmap 后在映射上逐行词法分析。
+ *
+ * 返回值：
+ *   - 最后一条命令的退出码；打不开时 127（不存在）或 126
+ */
+int run_script(t_minishell *minishell, const char *path)
+{
+    struct stat st;
+    char *buf = NULL;
+    size_t len = 0;
+    int mapped = 0;
+    int status;
+    int fd;
+
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return script_error(path, errno);
+    if (fstat(fd, &st) < 0)
+    {
+        status = script_error(path, errno);
+        return (close(fd), status);
+    }
+    if (S_ISDIR(st.st_mode))
+        return (close(fd), script_error(path, EISDIR));
+    if (S_ISREG(st.st_mode) && st.st_size == 0)
+        return (close(fd), 0);
+    if (S_ISREG(st.st_mode))
+    {
+        len = st.st_size;
+        buf = map_script(fd, len);
+        mapped = (buf != NULL);
+    }
+    if (!buf)
+        buf = read_all(fd, &len);
+    close(fd);
+    if (!buf)
+        return script_error(path, errno);
+    status = run_buffer(minishell, buf, len);
+    if (mapped)
+        munmap(buf, len);
+    else
+        free(buf);
+    return status;
+}
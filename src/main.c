@@ -27,27 +27,12 @@
  *   - 0 : 所有引号均已闭合
  *
  * 行为说明：
- *   1. 使用两个标志变量 single 和 dbl 分别跟踪单引号和双引号的开闭状态
- *   2. 遍历字符串：
- *        - 遇到单引号且不在双引号内部，切换 single 状态
- *        - 遇到双引号且不在单引号内部，切换 dbl 状态
- *   3. 遍历结束后，如果任一标志为 1，说明有未闭合的引号
+ *   直接复用词法/展开共用的引号扫描器 quote_scan（不写注解），
+ *   保证“是否需要补行”与后续分词对引号的判断完全一致。
  */
 static int has_unclosed_quotes(const char *s)
 {
-    int single = 0;
-    int dbl = 0;
-    size_t i = 0;
-
-    while (s[i])
-    {
-        if (s[i] == '\'' && dbl == 0)
-            single = !single;
-        else if (s[i] == '"' && single == 0)
-            dbl = !dbl;
-        i++;
-    }
-    return (single || dbl);
+    return (quote_scan(s, NULL) != 0);
 }
 
 /**
@@ -117,13 +102,60 @@ static char *get_relative_path(const char *cwd)
     return strdup(cwd);
 }
 
+/* readline 回调接口读到的一整行（EOF 为 NULL）与是否已读完 */
+static char *g_rl_line;
+static int g_rl_done;
+
+/* rl_callback_read_char 读完一整行时调用。立即卸下回调，
+ * 否则 readline 会马上为下一行重新显示提示符 */
+static void on_rl_line(char *line)
+{
+    g_rl_line = line;
+    g_rl_done = 1;
+    rl_callback_handler_remove();
+}
+
+/**
+ * ev_readline
+ * ----------------
+ * 目的：
+ *   代替 readline(prompt)：用 readline 的回调接口，由事件核心驱动。
+ *   标准输入可读时喂给 readline 一个字符；Ctrl+C 作为事件到达，
+ *   在这里（而不是在信号处理函数里）清空当前输入行。
+ *
+ * 返回值：
+ *   - 读到的行（由 readline 分配）；EOF 为 NULL
+ *   - Ctrl+C 时返回空串，并把 g_signal 置为 SIGINT 交给调用者
+ */
+static char *ev_readline(const char *prompt)
+{
+    g_rl_line = NULL;
+    g_rl_done = 0;
+    rl_callback_handler_install(prompt, on_rl_line);
+    while (!g_rl_done)
+    {
+        if (ev_wait_fd(STDIN_FILENO) < 0)
+        {
+            rl_free_line_state();
+            rl_callback_sigcleanup();
+            rl_replace_line("", 0);
+            rl_callback_handler_remove();
+            write(1, "\n", 1);
+            g_signal = SIGINT;
+            return strdup("");
+        }
+        rl_callback_read_char();
+    }
+    return g_rl_line;
+}
+
 /*
  * 函数名: read_complete_line
  * -----------------------------------------------------------------------------
  * 功能:
  * 1. 获取当前工作目录 (CWD)，并转换为相对于 $HOME 的相对路径（例如：~）。
  * 2. 使用 get_relative_path 的结果和 "$ " 常量生成完整的 readline 提示符。
- * 3. 使用 readline() 获取用户输入。
+ * 3. 使用 ev_readline()（事件核心驱动的 readline）获取用户输入。
  * 4. 检查输入是否包含未闭合的引号 ('has_unclosed_quotes' 假定实现)，如果包含，
  * 则循环使用 "> " 提示符读取后续行，直到引号闭合或用户按下 EOF (Ctrl+D)。
  * 5. 使用 ft_strjoin_free 拼接多行输入。
@@ -148,14 +180,20 @@ static char *read_complete_line(void)
     free(relative_path);
     if (!full_prompt)
         return (NULL);
-    line = readline(full_prompt);
+    line = ev_readline(full_prompt);
     if (!line)
-        return NULL;
-    while (has_unclosed_quotes(line))
+        return (free(full_prompt), NULL);
+    while (g_signal != SIGINT && has_unclosed_quotes(line))
     {
-        next = readline("> ");
+        next = ev_readline("> ");
         if (!next)
             break;
+        if (g_signal == SIGINT) // Ctrl+C 放弃整条未完成的命令
+        {
+            free(line);
+            line = next;
+            break;
+        }
         line = ft_strjoin_free(line, next, 1, 1);
     }
     free(full_prompt);
@@ -163,58 +201,36 @@ static char *read_complete_line(void)
 }
 
 /**
- * main
+ * interactive_loop
  * ----------------
  * 目的：
- *   Minishell 主函数：循环读取用户输入，进行词法分析、解析、执行，
- *   并在每次循环结束后释放相关资源。
- *
- * 参数：
- *   - argc : 命令行参数数量（未使用）
- *   - argv : 命令行参数数组（未使用）
- *
- * 返回值：
- *   - 返回 0 表示正常退出
+ *   交互模式的主循环：用 readline 显示提示符读取一整行，
+ *   记入历史后交给 run_line 执行，直到 EOF (Ctrl+D)。
  *
  * 行为说明：
- *   1. 无限循环读取用户输入
- *   2. 调用 read_complete_line 获取完整命令行（支持多行未闭合引号）
- *   3. 如果输入为 NULL（用户中断或 EOF），打印 "exit" 并退出循环
- *   4. 忽略空行，添加非空行到历史记录
- *   5. 分配 t_minishell 结构存储命令行及后续处理信息
- *   6. 词法分析阶段：
- *        - 调用 handle_lexer 生成 token 列表
- *        - 打印 token 供调试
- *   7. 如果词法分析失败，释放资源并继续循环
- *   8. 解析阶段：
- *        - 调用 parse_cmdline 生成 AST
- *        - 打印 AST 结构
- *        - 执行 AST（exec_ast）
- *        - 释放 AST 内存
- *   9. 循环结束时释放 lexer、命令行字符串和 t_minishell 结构
- *  10. 退出循环后清理 readline 历史记录
+ *   1. 调用 read_complete_line 获取完整命令行（支持多行未闭合引号）
+ *   2. 如果输入为 NULL（用户中断或 EOF），打印 "exit" 并退出循环
+ *   3. 忽略空行，添加非空行到历史记录
+ *   4. run_line 完成词法分析、展开、解析与执行，
+ *      并在本行结束时 arena_reset 一次性回收 token/argv/redir/AST
+ *   5. 退出循环后清理 readline 历史记录
  */
-
-int main(int argc, char *argv[], char **envp)
+static void interactive_loop(t_minishell *general)
 {
-    (void)argc;
-    (void)argv;
-
+    uint64_t t;
     char *buf;
-    t_minishell *general;
-    t_env *env = init_env(envp);
-    general = ft_calloc(1, sizeof(t_minishell));
-    struct sigaction sa;
-    sigemptyset(&sa.sa_mask);
-    sa.sa_handler = sigint_prompt;
-    sa.sa_flags = 0;
-    sigaction(SIGINT, &sa, NULL);
-    signal(SIGQUIT, SIG_IGN);
 
+    rl_catch_signals = 0; // 信号由 shell 自己处理，readline 不装处理函数
+    general->interactive = 1;
+    general->in = rd_stdin();
     while (1)
     {
         setup_prompt_signals();
+        jobs_notify(&general->jobs, 0); // 报告结束了的后台作业
+        g_signal = 0; // 上一行执行期间的 Ctrl+C 已由前台命令的结束处理过
+        t = trace_now();
         buf = read_complete_line();
+        trace_span("read", t, NULL, 0);
         if (g_signal == SIGINT)
         {
             general->last_exit_status = 130;
@@ -225,62 +241,122 @@ int main(int argc, char *argv[], char **envp)
             printf("exit\n");
             break;
         }
-
-        if (*buf == '\0')
+        if (*buf != '\0')
         {
-            free(buf);
-            continue;
+            add_history(buf);
+            run_line(general, buf);
         }
-        add_history(buf);
+        free(buf);
+    }
+    clear_history();
+    if (general->in)
+        rd_free(general->in);
+    general->in = NULL;
+}
 
-        if (!general)
-        {
-            perror("calloc");
-            free(buf);
-            break;
-        }
-        change_envp(env, &envp);
-        general->envp = envp;
-        general->raw_line = buf;
-        // === Lexer 阶段 ===
-        if (handle_lexer(general))
-        {
-            // printf("Lexer tokens:\n");
-            // print_lexer(general->lexer);
-        }
-        if (!general->lexer)
+/**
+ * take_stats_opts
+ * ----------------
+ * 目的：
+ *   从参数中取出 --stats / --stats=json（必须完全相同，可以出现在
+ *   -c 命令串或脚本名的前后），登记退出时的统计输出；
+ *   -c 后面的命令串原样保留，即使它恰好是 --stats。
+ *   其余参数按原顺序前移。
+ *
+ * 返回值：
+ *   - 剩下的参数个数（含 argv[0]）
+ */
+static int take_stats_opts(int argc, char **argv)
+{
+    int n = 1;
+    int json;
+
+    for (int i = 1; i < argc; i++)
+    {
+        json = (strcmp(argv[i], "--stats=json") == 0);
+        if (json || strcmp(argv[i], "--stats") == 0)
         {
-            fprintf(stderr, "tokenize failed\n");
-            free(buf);
+            stats_at_exit(json);
             continue;
         }
-        //=== expander 阶段 ===
-        expander_list(general, general->lexer);
-        // === Parser 阶段 ===
-        t_lexer *cursor = general->lexer;
-        ast *root = parse_cmdline(&cursor, general);
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+            argv[n++] = argv[i++];
+        argv[n++] = argv[i];
+    }
+    argv[n] = NULL;
+    return n;
+}
 
-        if (root)
-        {
-            // printf("=== AST ===\n");
-            // print_ast(root, 0);
-            int status = exec_ast(root, &env, general);
+/**
+ * main
+ * ----------------
+ * 目的：
+ *   Minishell 主函数：建立变量表与 t_minishell（含本进程唯一的 arena），
+ *   按参数选择运行方式，结束后释放所有资源。
+ *
+ * 用法：
+ *   - minishell                : 交互模式（readline、历史、提示符）
+ *   - minishell -c 'cmdline'   : 执行命令串后退出
+ *   - minishell script.msh     : 执行脚本（mmap 后逐行执行）后退出
+ *   - 标准输入不是终端时       : 批处理模式，逐行读取执行（见 run_batch）
+ *   - 以上任一种加上 --stats    : 退出时在 stderr 输出统计（--stats=json 为 JSON）
+ *   后两者不初始化 readline，不记历史，不计算提示符。
+ *   设置了 MINISHELL_DEBUG 时每行结束打印分配统计与展开统计；
+ *   设置了 MINISHELL_TRACE=文件 时记录各阶段与子进程的时间线，退出时写成 trace JSON。
+ *   设置了 MINISHELL_LASTPIPE 时打开 lastpipe（shell 自己的选项，不传给子进程）。
+ *
+ * 返回值：
+ *   - 交互模式返回 0；-c / 脚本模式返回最后一条命令的退出码
+ */
+int main(int argc, char *argv[], char **envp)
+{
+    t_minishell *general;
+    t_env *env = env_create(envp);
+    int status = 0;
 
-            // printf("status is  %d\n", status);
-            general->last_exit_status = status; // 保存退出码
-            free_ast(root);
-        }
+    general = ft_calloc(1, sizeof(t_minishell));
+    if (general)
+    {
+        general->arena = arena_new();
+        general->debug = (getenv("MINISHELL_DEBUG") != NULL);
+        trace_init();
+        general->env = env;
+        general->lastpipe = (getenv("MINISHELL_LASTPIPE") != NULL);
+        if (env)
+            env_unset(env, "MINISHELL_LASTPIPE");
+        ev_watch(&general->jobs);
+    }
+    argc = take_stats_opts(argc, argv);
+    if (!general || !general->arena || !env)
+    {
+        perror("calloc");
+        status = 1;
+    }
+    else if (argc > 1 && strcmp(argv[1], "-c") == 0)
+    {
+        if (argc > 2)
+            status = run_string(general, argv[2]);
         else
         {
-            // fprintf(stderr, "Parsing failed.\n");
+            fprintf(stderr, "minishell: -c: option requires an argument\n");
+            status = 2;
         }
-        // === 清理内存 ===
-        free_tokens(general->lexer);
-        general->lexer = NULL;
-        free(buf);
     }
-    clear_history();
-    free(buf);
-    free(env);
-    return 0;
-}
\ No newline at end of file
+    else if (argc > 1)
+        status = run_script(general, argv[1]);
+    else if (!isatty(STDIN_FILENO))
+        status = run_batch(general);
+    else
+        interactive_loop(general);
+    if (general)
+    {
+        tokens_free(&general->tokens);
+        sb_free(&general->expand_buf);
+        cmd_cache_clear(&general->cmds);
+        jobs_free(&general->jobs);
+        arena_destroy(general->arena);
+        free(general);
+    }
+    env_destroy(env);
+    return status;
+}
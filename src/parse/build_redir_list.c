@@ -18,43 +18,40 @@
  * 目的：
  *   为解析阶段创建一个新的重定向节点（t_redir），并根据
  *   token 类型设置其重定向种类（输入、输出、追加、heredoc）。
- *   同时会复制文件名（或 delimiter）字符串，以保证内存独立性。
  *
  * 参数：
+ *   @arena   - 本行的内存池，节点从这里分配
+ *
  *   @type    - 来自词法分析的 token 类型（tok_type）
  *              TOK_REDIR_IN, TOK_REDIR_OUT, TOK_APPEND, TOK_HEREDOC
  *
  *   @content - 重定向后跟随的目标文件名或 heredoc 的 delimiter。
- *              该字符串由 lexer 提供，这里会 strdup() 创建副本。
+ *              该字符串由 lexer 放在同一个 arena 中，直接引用即可。
  *
  * 返回值：
  *   成功：返回新创建且初始化完毕的 t_redir 指针
  *   失败：返回 NULL（内存分配失败）
  *
  * 逻辑说明：
- *   1. 分配一个 t_redir 节点并初始化为 0。
- *   2. 使用 strdup() 复制 content，确保 redir 节点拥有自己的内存。
+ *   1. 从 arena 分配一个 t_redir 节点并初始化为 0。
+ *   2. filename 直接指向 content（与 AST 同生命周期）。
  *   3. 根据 token 类型设置节点的重定向类型：
  *         - TOK_REDIR_IN   -> `<`
  *         - TOK_REDIR_OUT  -> `>`
  *         - TOK_APPEND     -> `>>`
  *         - TOK_HEREDOC    -> `<<`
+ *         - TOK_HERESTRING -> `<<<`（与 heredoc 一样以 heredoc_fd 提供输入）
  *   4. heredoc_fd 初始化为 -1，表示暂未创建管道。
  *   5. 返回配置完成的节点。
  */
-static t_redir	*create_redir(tok_type type, char *content)
+static t_redir	*create_redir(t_arena *arena, tok_type type, char *content)
 {
 	t_redir	*new_node;
 
-	new_node = ft_calloc(1, sizeof(t_redir));
+	new_node = arena_calloc(arena, 1, sizeof(t_redir));
 	if (!new_node)
 		return (NULL);
-	new_node->filename = ft_strdup(content);
-	if (!new_node->filename)
-	{
-		free(new_node);
-		return (NULL);
-	}
+	new_node->filename = content;
 	new_node->next = NULL;
 	new_node->heredoc_fd = -1;
 	if (type == TOK_REDIR_IN)
@@ -63,7 +60,7 @@ static t_redir	*create_redir(tok_type type, char *content)
 		new_node->type = REDIR_OUTPUT;
 	else if (type == TOK_APPEND)
 		new_node->type = REDIR_APPEND;
-	else if (type == TOK_HEREDOC)
+	else if (type == TOK_HEREDOC || type == TOK_HERESTRING)
 		new_node->type = HEREDOC;
 	return (new_node);
 }
@@ -116,7 +113,7 @@ static void redirlst_add_back(t_redir **lst, t_redir *new_node)
  *   构建对应的 t_redir 节点并追加到重定向链表中。
  *
  * 参数：
- *   @cur   - 指向当前 lexer 指针的地址（t_lexer**）。
+ *   @cur   - token 游标（t_cursor*）。
  *            本函数会从 token 流中消费两个 token：
  *            1. 重定向操作符（<, >, >>, <<）
  *            2. 后面的文件名（TOK_WORD）
@@ -135,37 +132,43 @@ static void redirlst_add_back(t_redir **lst, t_redir *new_node)
  *   1. 从 token 流中取出重定向符号与下一 token（文件名）。
  *   2. 若格式错误或 token 类型不正确，则释放 AST 并返回 NULL。
  *   3. 根据 token 类型创建对应的 t_redir 节点（create_redir）。
- *   4. 如果是 heredoc (<<)，调用 handle_heredoc() 处理内容。
+ *   4. 如果是 heredoc (<<)，调用 handle_heredoc() 读取正文；
+ *      如果是 here-string (<<<)，调用 handle_herestring() 写入 word。
  *   5. 将新节点追加到 redir 链表末尾。
  *   6. 返回更新后的 redir 链表头。
  */
 // 修改返回值为 int 或 bool，通过参数返回链表
-int build_redir(t_lexer **cur, t_redir **redir_list, t_minishell *minishell)
+int build_redir(t_cursor *cur, t_redir **redir_list, t_minishell *minishell)
 {
-    t_lexer *op = consume_token(cur);
-    if (!op) return (0);
+    int op = consume_token(cur);
+    if (op < 0) return (0);
+    tok_type op_type = cur->toks->type[op];
 
-    t_lexer *filetok = consume_token(cur);
-    if (!filetok || filetok->tokentype != TOK_WORD)
+    if (peek_token(cur) != TOK_WORD)
     {
         ft_putstr_fd("minishell: syntax error near unexpected token\n", 2);
         minishell->last_exit_status = 2;
         return (0);
     }
 
-    t_redir *new_redir = create_redir(op->tokentype, filetok->str);
+    int filetok = consume_token(cur);
+
+    t_redir *new_redir = create_redir(minishell->arena, op_type,
+                                      token_str(cur, filetok));
     if (!new_redir) return (0);
+    if (op_type != TOK_HEREDOC && op_type != TOK_HERESTRING)
+        new_redir->fq = token_qctx(cur, filetok);
 
-    if (op->tokentype == TOK_HEREDOC)
+    if (op_type == TOK_HEREDOC)
     {
         if (handle_heredoc(new_redir, minishell) == -1)
         {
-            // 失败时直接销毁当前这个无效节点，不加入链表
-            free(new_redir->filename);
-            free(new_redir);
-            return (0); 
+            // 失败时直接丢弃当前这个无效节点，不加入链表（内存属于 arena）
+            return (0);
         }
     }
+    else if (op_type == TOK_HERESTRING && handle_herestring(new_redir) == -1)
+        return (0);
 
     // 正确挂载到外部传入的链表地址
     redirlst_add_back(redir_list, new_redir);
@@ -1,122 +1,110 @@
 #include "../../include/minishell.h"
 
-volatile sig_atomic_t g_signal; // 唯一全局变量
-
-/* SIGINT handler */
-void sigint_heredoc(int sig)
+/* heredoc_loop: 逐行读取正文写进 store，遇到只有 delimiter 的一行结束
+ * 从共享的标准输入读取器取行（管道上可以一次读走到结束行为止，见 rd_set_stop），
+ * 正文经 store 的缓冲写入器批量写出；提示符只在终端上显示
+ * 终端上缓冲区里没有整行时先在事件核心上等输入：Ctrl+C 作为事件返回，
+ * 不靠信号处理函数让 read 以 EINTR 失败
+ * 返回：0 正常结束；-1 Ctrl+C；-2 写入失败 */
+int heredoc_loop(t_reader *in, t_hdoc *store, const char *delimiter)
 {
-    (void)sig;
-    g_signal = SIGINT;
-}
-
-/* heredoc_loop: canonical 模式，和 bash 行为一致 */
-int heredoc_loop(int write_fd, const char *delimiter)
-{
-    char *line;
-    char *full_line = NULL; // 用于拼接没有换行符的片段
-
-    struct sigaction sa = {.sa_handler = sigint_heredoc, .sa_flags = 0};
-    sigaction(SIGINT, &sa, NULL);
+    t_line line;
+    size_t dlen = strlen(delimiter);
+    int tty = isatty(in->fd);
+    int rc;
 
     while (1)
     {
-        // 只有当缓冲区为空时，才打印提示符
-        if (full_line == NULL)
-            write(STDOUT_FILENO, "heredoc> ", 9);
-
-        g_signal = 0;
-        line = get_next_line(STDIN_FILENO);
-
-        // --- 处理 Ctrl+C ---
-        if (g_signal == SIGINT)
-        {
-            free(line);
-            free(full_line);
-            write(1, "\n", 1);
-            return -1;
-        }
-
-        // --- 处理 Ctrl+D ---
-        if (!line)
-        {
-            if (full_line == NULL)
-            { // 纯空行按 Ctrl+D
-                printf("bash: warning: ... (wanted '%s')\n", delimiter);
-                break;
-            }
-            // 如果有残留内容按 Ctrl+D，Bash 会将其视为一行处理
-            line = full_line;
-            full_line = NULL;
-        }
-        else if (full_line)
-        { // 如果之前有没写完的片段，拼接起来
-            char *tmp = ft_strjoin(full_line, line);
-            free(full_line);
-            free(line);
-            line = tmp;
-        }
-
-        // --- 判断是否读到了完整的一行 ---
-        size_t len = strlen(line);
-        if (len > 0 && line[len - 1] == '\n')
+        if (tty)
         {
-            line[len - 1] = '\0'; // 去掉换行符
-            if (strcmp(line, delimiter) == 0)
+            write(STDOUT_FILENO, "heredoc> ", 9);
+            // --- 处理 Ctrl+C ---
+            if (!rd_buffered(in) && ev_wait_fd(in->fd) < 0)
             {
-                free(line);
-                break;
+                write(1, "\n", 1);
+                return -1;
             }
-            write(write_fd, line, strlen(line));
-            write(write_fd, "\n", 1);
-            free(line);
-            full_line = NULL; // 清空暂存，下次循环会打印提示符
         }
-        else
+        rc = rd_line(in, &line);
+
+        // --- 处理 Ctrl+D / 读取出错 ---
+        // 末尾没有换行的残留内容由 rd_line 作为最后一行返回，与 bash 一样视为一行
+        if (rc <= 0)
         {
-            // 没有换行符，说明用户按了 Ctrl+D
-            // 我们暂存这段文字，进入下一次 read，不打印提示符
-            full_line = line;
+            printf("bash: warning: ... (wanted '%s')\n", delimiter);
+            break;
         }
+        if (line.len == dlen && memcmp(line.ptr, delimiter, dlen) == 0)
+            break;
+        if (!hdoc_write(store, line.ptr, line.len) || !hdoc_write(store, "\n", 1))
+            return -2;
     }
     return 0;
 }
 
 int handle_heredoc(t_redir *new_redir, t_minishell *shell)
 {
-    int pipefd[2];
-    pid_t pid;
-    int status;
-
-    if (pipe(pipefd) < 0)
-        return -1;
+    t_hdoc store;
+    t_reader *in;
+    uint64_t t;
+    int rc;
 
-    pid = fork();
-    if (pid < 0)
+    t = trace_now();
+    if (!hdoc_open(&store))
+    {
+        perror("heredoc");
         return -1;
-
-    if (pid == 0)
+    }
+    // 正文从当前输入读取：交互时是标准输入，脚本 / -c 模式下是脚本本身
+    in = shell->in ? shell->in : rd_stdin();
+    rc = -2;
+    if (in)
     {
-        close(pipefd[0]);
-        if (heredoc_loop(pipefd[1], new_redir->filename) < 0)
-            exit(130);
-        close(pipefd[1]);
-        exit(0);
+        rd_set_stop(in, new_redir->filename);
+        rc = heredoc_loop(in, &store, new_redir->filename);
+        rd_set_stop(in, NULL);
     }
-
-    close(pipefd[1]);
-    signal(SIGINT, SIG_IGN);
-    signal(SIGQUIT, SIG_IGN);
-
-    waitpid(pid, &status, 0);
-
-    if (WIFEXITED(status) && WEXITSTATUS(status) == 130)
+    if (rc < 0)
     {
-        close(pipefd[0]);
+        hdoc_discard(&store);
         new_redir->heredoc_fd = -1;
+        if (rc == -2)
+        {
+            perror("heredoc");
+            return -1;
+        }
         shell->last_exit_status = 130;
         return -1;
     }
+    stats_add(STC_HEREDOCS, 1);
+    stats_add(STC_HEREDOC_BYTES, store.size);
+    trace_span("heredoc", t, "bytes", (long)store.size);
+    new_redir->heredoc_fd = hdoc_finish(&store);
+    if (new_redir->heredoc_fd < 0)
+        return (perror("heredoc"), -1);
+    return 0;
+}
 
-    new_redir->heredoc_fd = pipefd[0];
+/* here-string（<<< word）：展开后的 word 加一个换行就是全部内容，
+ * 与 heredoc 共用同一个存储，执行时同样以 heredoc_fd 接到标准输入 */
+int handle_herestring(t_redir *new_redir)
+{
+    t_hdoc store;
+
+    if (!hdoc_open(&store))
+    {
+        perror("here-string");
+        return -1;
+    }
+    if (!hdoc_write(&store, new_redir->filename, strlen(new_redir->filename))
+        || !hdoc_write(&store, "\n", 1))
+    {
+        perror("here-string");
+        hdoc_discard(&store);
+        return -1;
+    }
+    new_redir->heredoc_fd = hdoc_finish(&store);
+    if (new_redir->heredoc_fd < 0)
+        return (perror("here-string"), -1);
     return 0;
 }
@@ -0,0 +1,126 @@
+#define _GNU_SOURCE
+#include "../../include/minishell.h"
+#include <sys/mman.h>
+
+// heredoc 内容的存储：先写进内存文件（memfd），超过 HEREDOC_MEM_MAX
+// 后整体搬到一个已 unlink 的临时文件。两者都是普通的可 seek 的 fd，
+// 写完后 lseek 回开头，直接作为 heredoc_fd 交给重定向使用；
+// 不再需要子进程和管道，内容再大也不会因为管道写满而卡死
+
+// 打开一个已 unlink 的临时文件（在 TMPDIR 下，默认 /tmp）
+static int open_tmpfile(void)
+{
+    const char *dir = getenv("TMPDIR");
+    char path[PATH_MAX];
+    int fd;
+
+    if (!dir || !*dir)
+        dir = "/tmp";
+    if (snprintf(path, sizeof(path), "%s/minishell-heredoc-XXXXXX", dir)
+        >= (int)sizeof(path))
+        return -1;
+    fd = mkstemp(path);
+    if (fd < 0)
+        return -1;
+    unlink(path);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    return fd;
+}
+
+// 内容超过内存上限：拷到临时文件，关掉 memfd。
+// 借写入器的缓冲区做搬运（调用前已 flush，此时缓冲区是空的）
+static int hdoc_spill(t_hdoc *h)
+{
+    off_t off = 0;
+    ssize_t r;
+    int fd = open_tmpfile();
+
+    if (fd < 0)
+        return 0;
+    while ((r = pread(h->out.fd, h->out.buf, h->out.cap, off)) > 0)
+    {
+        if (!io_write_all(fd, h->out.buf, r))
+            break;
+        off += r;
+    }
+    if (off != (off_t)h->size)
+    {
+        close(fd);
+        return 0;
+    }
+    close(h->out.fd);
+    h->out.fd = fd;
+    h->on_disk = 1;
+    return 1;
+}
+
+/**
+ * hdoc_open
+ * ----------------
+ * 目的：
+ *   准备一个空的 heredoc 存储。优先使用 memfd，
+ *   系统不支持时直接用临时文件。
+ *
+ * 返回值：
+ *   - 成功返回 1；失败返回 0（errno 保留）
+ */
+int hdoc_open(t_hdoc *h)
+{
+    int fd = -1;
+
+    h->size = 0;
+    h->on_disk = 0;
+#ifdef MFD_CLOEXEC
+    fd = memfd_create("heredoc", MFD_CLOEXEC);
+#endif
+    if (fd < 0)
+    {
+        fd = open_tmpfile();
+        h->on_disk = 1;
+    }
+    if (fd < 0)
+        return 0;
+    if (!wr_init(&h->out, fd, IO_BUF_SIZE))
+    {
+        close(fd);
+        return 0;
+    }
+    return 1;
+}
+
+// 追加 n 个字节（先进写入器的缓冲区）；写满内存上限时先搬到磁盘。失败返回 0
+int hdoc_write(t_hdoc *h, const char *s, size_t n)
+{
+    if (!h->on_disk && h->size + n > HEREDOC_MEM_MAX
+        && (!wr_flush(&h->out) || !hdoc_spill(h)))
+        return 0;
+    if (!wr_put(&h->out, s, n))
+        return 0;
+    h->size += n;
+    return 1;
+}
+
+// 写完：写出缓冲区，回到开头，返回可直接读取的 fd（所有权交给调用者）
+int hdoc_finish(t_hdoc *h)
+{
+    int fd = h->out.fd;
+    int ok = wr_flush(&h->out);
+
+    wr_free(&h->out);
+    h->out.fd = -1;
+    if (!ok || lseek(fd, 0, SEEK_SET) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// 放弃（Ctrl+C、出错）：关闭并丢弃已写入的内容
+void hdoc_discard(t_hdoc *h)
+{
+    wr_free(&h->out);
+    if (h->out.fd >= 0)
+        close(h->out.fd);
+    h->out.fd = -1;
+}
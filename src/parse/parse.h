@@ -15,7 +15,8 @@
 
 #include "../../libft/libft.h"
 
-#define BUFFER_SIZE 42
+// heredoc 正文超过这个大小后从内存文件搬到磁盘上的临时文件
+#define HEREDOC_MEM_MAX (1 << 20)
 
 typedef enum
 {
@@ -26,8 +27,13 @@ typedef enum
     NODE_SUBSHELL,
     NODE_BACKGROUND,
     NODE_SEQUENCE,
+    NODE_TIME,
 } node_type;
 
+// time 的选项（ast.flags）：-p 按 POSIX 格式输出；-v 另外逐个阶段列出资源用量
+#define TIME_POSIX 1
+#define TIME_VERBOSE 2
+
 typedef enum e_redir_type
 {
     REDIR_INPUT,
@@ -36,50 +42,34 @@ typedef enum e_redir_type
     HEREDOC,
 } t_redir_type;
 
+// heredoc / here-string 正文的存储（见 heredoc_store.c）
+// out：写入 memfd 或已 unlink 的临时文件的缓冲写入器（out.fd 即存储本身）
+// size：已写入的总字节数；on_disk：是否已经搬到临时文件
+typedef struct s_hdoc
+{
+    t_writer out;
+    size_t size;
+    int on_disk;
+} t_hdoc;
+
 typedef struct s_redir
 {
     struct s_redir *next;
     char *filename;
     int heredoc_fd;
     bool is_expanded;
+    unsigned char *fq; // filename 含 $、展开推迟到执行时：它的引号注解；否则为 NULL
     t_redir_type type;
 
 } t_redir;
-/**
- * @struct s_cmd
- * @brief  单向链表节点，用于在解析阶段暂存命令参数（argv）。
- *
- * 该结构体只在“解析阶段”使用，用于临时保存每一个解析到的
- * 单词（token），最终会被转换为 AST 节点中的 node->argv（char **）。
- *
- * 生命周期与所有权（非常关键）：
- * --------------------------------------------------------------
- * 1) 在解析时，每读到一个 TOK_WORD，就会创建一个 t_cmd 节点：
- *        new->arg = strdup(token->str);
- *
- * 2) 解析完成后，会将整个 t_cmd 链表复制到 node->argv：
- *        node->argv[i] = strdup(tmp->arg);
- *
- * 3) 复制完成后，这个链表中的字符串(new->arg) 及链表节点本身
- *    会由 free_argv_list() 统一释放。
- *
- * 重要：最终的内存所有者是 AST 中的 node->argv（char **）。
- *      t_cmd 链表只是构造阶段的临时容器。
- *
- * 这样设计的好处：
- *  - 避免 node->argv 与临时链表共享同一块字符串（从而避免 double-free）。
- *  - 解析时能方便按顺序收集参数。
- *  - 错误恢复逻辑（free_ast_partial）更简单明确。
- *
- * @field arg   strdup 得到的单个参数字符串（临时所有者）
- * @field next  指向下一个 t_cmd 节点（单向链表）
- */
-typedef t_list t_cmd;
 typedef struct s_ast
 {
     node_type type;
     // 当为node_cmd时
     char **argv;
+    // 与 argv 对应：含 $ 的参数展开推迟到执行时（expand_cmd），这里是它的引号注解；
+    // 都不需要展开时整个为 NULL
+    unsigned char **argq;
     t_redir *redir;
     int n_pipes;
     // 当为组合节点时
@@ -87,36 +77,44 @@ typedef struct s_ast
     struct s_ast *right;
     // 当为子shell时
     struct s_ast *sub;
+    // 当为 NODE_TIME 时：被计时的管道在 left（可以为空），选项见 TIME_POSIX
+    int flags;
 } ast;
 
 void free_ast(ast *node);
-void free_tokens(t_lexer *tok);
 void free_ast_partial(ast *node);
-void free_argv_list(t_cmd *a);
 void free_redir_list(t_redir *r);
-t_lexer *peek_token(t_lexer **cur);
-t_lexer *consume_token(t_lexer **cur);
-t_lexer *expect_token(tok_type type, t_lexer **cur);
-int is_redir_token(t_lexer *pt);
+tok_type peek_token(t_cursor *cur);
+tok_type peek_token_at(t_cursor *cur, int ahead);
+int consume_token(t_cursor *cur);
+int expect_token(tok_type type, t_cursor *cur);
+char *token_str(t_cursor *cur, int idx);
+unsigned char *token_qctx(t_cursor *cur, int idx);
+int is_redir_token(tok_type type);
+int is_list_token(tok_type type);
+int is_reserved(t_cursor *cur, const char *word);
 void print_indent(int depth);
 void print_ast(ast *node, int depth);
 void print_ast_by_type(ast *node, int depth);
 void print_ast_pipe(ast *node, int depth);
 
 void print_ast_cmd(ast *node);
-ast *parse_cmdline(t_lexer **cur, t_minishell *minishell);
+ast *parse_cmdline(t_cursor *cur, t_minishell *minishell);
+ast *parse_list(t_cursor *cur, t_minishell *minishell);
 void print_ast_subshell(ast *node, int depth);
+void print_ast_list(ast *node, int depth);
 int main(int argc, char *argv[], char **envp);
-ast *parse_pipeline(t_lexer **cur, t_minishell *minishell);
-ast *parse_subshell(t_lexer **cur, ast *node, t_minishell *minishell);
+ast *parse_pipeline(t_cursor *cur, t_minishell *minishell);
+ast *parse_subshell(t_cursor *cur, ast *node, t_minishell *minishell);
 char *safe_strdup(const char *s);
-ast *parse_simple_cmd_redir_list(t_lexer **cur, t_minishell *minishell);
-void free_t_cmd_node(t_cmd *argv_cmd);
-int heredoc_loop(int write_fd, const char *delimiter);
+ast *parse_simple_cmd_redir_list(t_cursor *cur, t_minishell *minishell);
+int heredoc_loop(t_reader *in, t_hdoc *store, const char *delimiter);
 int handle_heredoc(t_redir *new_redir, t_minishell *minishell);
-int build_redir(t_lexer **cur, t_redir **redir_list, t_minishell *minishell); 
-char *get_next_line(int fd);
-int end_line(char *str);
-char *extract_line(char *str);
+int handle_herestring(t_redir *new_redir);
+int hdoc_open(t_hdoc *h);
+int hdoc_write(t_hdoc *h, const char *s, size_t n);
+int hdoc_finish(t_hdoc *h);
+void hdoc_discard(t_hdoc *h);
+int build_redir(t_cursor *cur, t_redir **redir_list, t_minishell *minishell); 
 
 #endif
@@ -12,41 +12,188 @@
 
 #include "../../include/minishell.h"
 
+// 报告语法错误（bash 的格式），$? 置 2。行尾报 `newline'
+static ast *syntax_error(t_cursor *cur, t_minishell *minishell)
+{
+    const char *tok;
+
+    tok = "newline";
+    if (peek_token(cur) != TOK_END)
+        tok = token_str(cur, cur->pos);
+    fprintf(stderr, "bash: syntax error near unexpected token `%s'\n", tok);
+    minishell->last_exit_status = 2;
+    return NULL;
+}
+
+// 组合节点：left op right，内存在本行 arena 中
+static ast *new_list_node(node_type type, ast *left, ast *right,
+    t_minishell *minishell)
+{
+    ast *node;
+
+    node = arena_calloc(minishell->arena, 1, sizeof(ast));
+    if (!node)
+    {
+        free_ast(left);
+        free_ast(right);
+        return NULL;
+    }
+    node->type = type;
+    node->left = left;
+    node->right = right;
+    return node;
+}
+
+// 列表的一个元素必须以命令开头：&&、||、;、&、) 出现在这里都是语法错误
+static int starts_command(tok_type type)
+{
+    return (!is_list_token(type) && type != TOK_RPAREN && type != TOK_END);
+}
+
+/**
+ * parse_timed
+ * ----------------
+ * 目的：
+ *   解析 [time [-p] [-v]] pipeline。time 是保留字（只在命令开头、不带引号时），
+ *   作用于整条管道而不是其中的一个命令：time a | b 计的是 a | b 的总用量。
+ *   time 后面没有命令时（time、time && x）计一条空命令，与 bash 相同。
+ */
+static ast *parse_timed(t_cursor *cur, t_minishell *minishell)
+{
+    ast *node;
+
+    if (!is_reserved(cur, "time"))
+        return parse_pipeline(cur, minishell);
+    consume_token(cur);
+    node = new_list_node(NODE_TIME, NULL, NULL, minishell);
+    if (!node)
+        return NULL;
+    while (is_reserved(cur, "-p") || is_reserved(cur, "-v"))
+    {
+        if (is_reserved(cur, "-p"))
+            node->flags |= TIME_POSIX;
+        else
+            node->flags |= TIME_VERBOSE;
+        consume_token(cur);
+    }
+    if (starts_command(peek_token(cur)))
+    {
+        node->left = parse_pipeline(cur, minishell);
+        if (!node->left)
+            return NULL;
+    }
+    return node;
+}
+
+/**
+ * parse_and_or
+ * ----------------
+ * 目的：
+ *   解析 pipeline { (&& | ||) pipeline }（每条 pipeline 前可以有 time），左结合：
+ *   a && b || c → ((a && b) || c)，与 bash 相同（&& 与 || 优先级相同）。
+ *
+ * 返回值：
+ *   - 成功：AST 根节点；失败：NULL（已报错、已关闭 heredoc fd）
+ */
+static ast *parse_and_or(t_cursor *cur, t_minishell *minishell)
+{
+    ast *left;
+    ast *right;
+    tok_type op;
+
+    if (!starts_command(peek_token(cur)))
+        return syntax_error(cur, minishell);
+    left = parse_timed(cur, minishell);
+    while (left && (peek_token(cur) == TOK_AND || peek_token(cur) == TOK_OR))
+    {
+        op = peek_token(cur);
+        consume_token(cur);
+        if (!starts_command(peek_token(cur)))
+            return (free_ast(left), syntax_error(cur, minishell));
+        right = parse_timed(cur, minishell);
+        if (!right)
+            return (free_ast(left), NULL);
+        if (op == TOK_AND)
+            left = new_list_node(NODE_AND, left, right, minishell);
+        else
+            left = new_list_node(NODE_OR, left, right, minishell);
+    }
+    return left;
+}
+
+/**
+ * parse_list
+ * ----------------
+ * 目的：
+ *   解析命令列表 and_or { (; | &) and_or } [; | &]，遇到行尾或 ')' 结束
+ *   （子 shell 的内容也是一个列表）。a ; b ; c → ((a ; b) ; c)；
+ *   以 & 结尾的元素包进 NODE_BACKGROUND（子树在 left）：a & b → (bg(a) ; b)。
+ *
+ * 返回值：
+ *   - 成功：AST 根节点；失败：NULL
+ */
+ast *parse_list(t_cursor *cur, t_minishell *minishell)
+{
+    ast *left;
+    ast *elem;
+    tok_type sep;
+
+    left = NULL;
+    while (1)
+    {
+        elem = parse_and_or(cur, minishell);
+        if (!elem)
+            return (free_ast(left), NULL);
+        sep = peek_token(cur);
+        if (sep == TOK_AMP)
+            elem = new_list_node(NODE_BACKGROUND, elem, NULL, minishell);
+        if (elem && left)
+            elem = new_list_node(NODE_SEQUENCE, left, elem, minishell);
+        else if (!elem)
+            free_ast(left);
+        left = elem;
+        if (!left || (sep != TOK_SEMI && sep != TOK_AMP))
+            break;
+        consume_token(cur);
+        if (peek_token(cur) == TOK_END || peek_token(cur) == TOK_RPAREN)
+            break;
+    }
+    return left;
+}
+
 /**
  * parse_cmdline
  * ----------------
  * 目的：
  *   解析完整的命令行输入，构建对应的 AST（抽象语法树）。
- *   主要处理管道、逻辑操作和简单命令的组合。
+ *   主要处理命令列表（; && ||）、管道和简单命令的组合。
  *
  * 参数：
- *   - cur : 指向当前 token 游标的指针，用于遍历 token 链表
+ *   - cur : token 游标，用于遍历 token 序列
  *
  * 返回值：
  *   - 成功：返回解析好的 AST 根节点指针
  *   - 失败：语法错误或解析失败时返回 NULL，并释放已分配的 AST
  *
  * 行为说明：
- *   1. 调用 parse_pipeline() 解析整个命令行的管道结构
+ *   1. 调用 parse_list() 解析整个命令行的列表结构
  *   2. 检查解析完成后是否还有剩余 token
  *      - 如果存在且不是 TOK_END，打印语法错误并释放 AST
  *   3. 返回 AST 根节点
  */
-ast *parse_cmdline(t_lexer **cur, t_minishell *minishell)
+ast *parse_cmdline(t_cursor *cur, t_minishell *minishell)
 {
     ast *root;
-    t_lexer *pt;
+    tok_type type;
 
-      
-    root = parse_pipeline(cur, minishell);
+    root = parse_list(cur, minishell);
     if (!root)
         return NULL;
-    pt = peek_token(cur);
-    if (pt && pt->tokentype != TOK_END)
+    type = peek_token(cur);
+    if (type != TOK_END)
     {
-        fprintf(stderr, "Syntax error: unexpected token at end (type %d)\n", pt->tokentype);
         free_ast(root);
-        return NULL;
+        return syntax_error(cur, minishell);
     }
     return root;
 }
@@ -20,7 +20,7 @@
  *   将左侧命令与右侧命令组合成一棵二叉树表示管道链。
  *
  * 参数：
- *   - cur     : 指向当前 token 游标的指针
+ *   - cur     : token 游标
  *   - left    : 指向已解析的左侧 AST 节点指针（输入/输出参数）
  *   - n_pipes : 指向管道数量计数器，每遇到一个 '|' 就递增
  *
@@ -35,20 +35,27 @@
  *   4. 为管道创建一个新的 NODE_PIPE AST 节点，将左/右子树连接
  *   5. 更新 left 指针为新创建的 PIPE 节点，继续处理后续管道
  */
-static ast *parse_pipeline_1(t_lexer **cur, ast **left, int *n_pipes, t_minishell *minishell)
+static ast *parse_pipeline_1(t_cursor *cur, ast **left, int *n_pipes, t_minishell *minishell)
 {
     ast *right;
-    t_lexer *pt;
 
-    while (peek_token(cur) && peek_token(cur)->tokentype == TOK_PIPE)
+    while (peek_token(cur) == TOK_PIPE)
     {
         // 检查是否是连续的管道符号
-        pt = peek_token(cur);
-        if (pt && pt->next && pt->next->tokentype == TOK_PIPE) // 连续的管道符号
+        if (peek_token_at(cur, 1) == TOK_PIPE) // 连续的管道符号
         {
             ft_putstr_fd("bash: syntax error near unexpected token `|'\n", STDERR_FILENO);
             return (free_ast(*left), NULL);
         }
+        // '|' 后面紧跟列表运算符或 ')'：语法错误，不能当作续行
+        if (is_list_token(peek_token_at(cur, 1))
+            || peek_token_at(cur, 1) == TOK_RPAREN)
+        {
+            fprintf(stderr, "bash: syntax error near unexpected token `%s'\n",
+                token_str(cur, cur->pos + 1));
+            minishell->last_exit_status = 2;
+            return (free_ast(*left), NULL);
+        }
 
         consume_token(cur);  // 消耗管道符号
 
@@ -60,8 +67,9 @@ static ast *parse_pipeline_1(t_lexer **cur, ast **left, int *n_pipes, t_minishel
         {
             //ft_putstr_fd("Error: expected command after pipe. Waiting for input...\n", STDERR_FILENO);
             
-            // 提示用户输入右侧命令
-            char *buf = readline("> ");
+            // 提示用户输入右侧命令（脚本 / -c 模式下直接取下一行）
+            // token 是指向 raw_line 的切片：返回的行在 arena 或脚本缓冲区里，与主行同寿命
+            char *buf = loop_more_line(minishell, "> ");
             if (!buf)  // 如果用户按下 Ctrl+D 退出
             {
                 printf("bash: syntax error: unexpected end of file\n");
@@ -72,26 +80,29 @@ static ast *parse_pipeline_1(t_lexer **cur, ast **left, int *n_pipes, t_minishel
 
             // 创建新的 t_minishell 结构体并解析输入
             t_minishell *test = calloc(1, sizeof(t_minishell));
-            if (!test) {
-                free(buf);
+            if (!test)
                 return (free_ast(*left), NULL);  // 内存分配失败，释放内存并返回
-            }
             test->raw_line = buf;
-            handle_lexer(test);  // 处理 lexer
-
-            // 继续解析右侧命令
-            right = parse_simple_cmd_redir_list(&(test->lexer), minishell);
-            if (!right) {
-                free(buf);
+            test->arena = minishell->arena;
+            if (!handle_lexer(test)
+                || !expander_list(minishell, &test->tokens))
+            {
+                tokens_free(&test->tokens);
                 free(test);
-                continue;  // 如果右侧命令还是为空，继续提示用户输入
+                continue;
             }
 
-            free(test);  // 使用完后释放
+            // 继续解析右侧命令
+            t_cursor sub = {&test->tokens, 0};
+            right = parse_simple_cmd_redir_list(&sub, minishell);
+            tokens_free(&test->tokens);  // 临时 token 序列的数组用完即释放
+            free(test);
+            if (!right)
+                continue;  // 如果右侧命令还是为空，继续提示用户输入
         }
 
         // 创建管道节点并连接左/右命令
-        ast *node = ft_calloc(1, sizeof(ast));
+        ast *node = arena_calloc(minishell->arena, 1, sizeof(ast));
         if (!node) {
             free_ast(*left);
             free_ast(right);
@@ -119,7 +130,7 @@ static ast *parse_pipeline_1(t_lexer **cur, ast **left, int *n_pipes, t_minishel
  *   构建成 PIPE 类型的 AST 树。
  *
  * 参数：
- *   - cur : 指向当前 token 游标的指针
+ *   - cur : token 游标
  *
  * 返回值：
  *   - 成功：返回包含整个管道结构的 AST 根节点
@@ -131,13 +142,13 @@ static ast *parse_pipeline_1(t_lexer **cur, ast **left, int *n_pipes, t_minishel
  *   3. 将管道数量 n_pipes 保存到 AST 根节点的 n_pipes 字段
  *   4. 返回 AST 根节点
  */
-ast *parse_pipeline(t_lexer **cur, t_minishell *minishell)
+ast *parse_pipeline(t_cursor *cur, t_minishell *minishell)
 {
     ast *left;
     int n_pipes;
 
     // 🚨 如果一开始就是 PIPE，直接报错
-    if (peek_token(cur) && peek_token(cur)->tokentype == TOK_PIPE)
+    if (peek_token(cur) == TOK_PIPE)
     {
         ft_putstr_fd(
             "bash: syntax error near unexpected token `|'\n",
@@ -19,7 +19,7 @@
  *   解析子 shell 表达式，即括号内的命令，并返回对应的 AST 节点。
  *
  * 参数：
- *   - cur  : 指向当前 token 游标的指针
+ *   - cur  : token 游标
  *   - node : 已分配的 AST 节点，用于存储子 shell 信息
  *
  * 返回值：
@@ -33,12 +33,14 @@
  *   4. 检查右括号 ')' 是否存在，若缺失打印语法错误并释放节点
  *   5. 返回子 shell AST 节点
  */
-ast *parse_subshell(t_lexer **cur, ast *node, t_minishell *minishell)
+ast *parse_subshell(t_cursor *cur, ast *node, t_minishell *minishell)
 {
     consume_token(cur);
     node->type = NODE_SUBSHELL;
-    node->sub = parse_pipeline(cur, minishell);
-    if (!expect_token(TOK_RPAREN, cur))
+    node->sub = parse_list(cur, minishell);
+    if (!node->sub)
+        return NULL;
+    if (expect_token(TOK_RPAREN, cur) < 0)
     {
         fprintf(stderr, "Syntax error: expected ')'\n");
         free_ast(node);
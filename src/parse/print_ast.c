@@ -99,6 +99,10 @@ void print_ast_by_type(ast *node, int depth)
         print_ast_pipe(node, depth);
     else if (node->type == NODE_SUBSHELL)
         print_ast_subshell(node, depth);
+    else if (node->type == NODE_AND || node->type == NODE_OR
+        || node->type == NODE_SEQUENCE || node->type == NODE_BACKGROUND
+        || node->type == NODE_TIME)
+        print_ast_list(node, depth);
     else
         printf("%*sUnknown AST node type %d\n", depth * 2, "", node->type);
 }
@@ -159,3 +159,26 @@ void print_ast_subshell(ast *node, int depth)
     printf("SUBSHELL\n");
     print_ast(node->sub, depth + 1);
 }
+
+/**
+ * print_ast_list
+ * ----------------
+ * 目的：
+ *   打印列表节点（NODE_AND / NODE_OR / NODE_SEQUENCE / NODE_BACKGROUND / NODE_TIME），
+ *   并递归打印左右子节点。
+ */
+void print_ast_list(ast *node, int depth)
+{
+    if (node->type == NODE_AND)
+        printf("AND\n");
+    else if (node->type == NODE_OR)
+        printf("OR\n");
+    else if (node->type == NODE_BACKGROUND)
+        printf("BACKGROUND\n");
+    else if (node->type == NODE_TIME)
+        printf("TIME\n");
+    else
+        printf("SEQUENCE\n");
+    print_ast(node->left, depth + 1);
+    print_ast(node->right, depth + 1);
+}
@@ -16,23 +16,41 @@
  * peek_token
  * ----------------
  * 目的：
- *   查看当前 token 游标指向的 token，但不移动游标。
+ *   查看当前游标指向的 token 类型，但不移动游标。
  *
  * 参数：
- *   - cur : 指向当前 token 游标的指针
+ *   - cur : token 游标
  *
  * 返回值：
- *   - 成功：返回当前 token 指针 (*cur)
- *   - 失败：如果 cur 为 NULL，返回 NULL
+ *   - 当前 token 的类型；游标已越过末尾或 cur 为 NULL 时返回 TOK_END
  *
  * 行为说明：
- *   - 不修改 cur 指向的 token，便于在解析时预览下一个 token
+ *   - token 序列以 TOK_END 哨兵结尾，越界访问统一视为 TOK_END
  */
-t_lexer *peek_token(t_lexer **cur)
+tok_type peek_token(t_cursor *cur)
 {
-    if (!cur)
-        return NULL;
-    return *cur;
+    return peek_token_at(cur, 0);
+}
+
+/**
+ * peek_token_at
+ * ----------------
+ * 目的：
+ *   向前看 ahead 个位置的 token 类型（ahead = 0 即当前 token）。
+ *
+ * 返回值：
+ *   - 对应 token 的类型；越界时返回 TOK_END
+ */
+tok_type peek_token_at(t_cursor *cur, int ahead)
+{
+    int i;
+
+    if (!cur || !cur->toks)
+        return TOK_END;
+    i = cur->pos + ahead;
+    if (i < 0 || i >= cur->toks->count)
+        return TOK_END;
+    return cur->toks->type[i];
 }
 
 /**
@@ -42,25 +60,80 @@ t_lexer *peek_token(t_lexer **cur)
  *   消耗当前 token，并将游标移动到下一个 token。
  *
  * 参数：
- *   - cur : 指向当前 token 游标的指针
+ *   - cur : token 游标
  *
  * 返回值：
- *   - 成功：返回被消耗的 token 指针
- *   - 失败：如果 cur 或 *cur 为 NULL，返回 NULL
+ *   - 成功：返回被消耗的 token 下标
+ *   - 失败：游标已越过末尾时返回 -1
  *
  * 行为说明：
- *   1. 保存当前 token 指针到临时变量 old
- *   2. 将游标 *cur 移动到下一个 token
- *   3. 返回原 token 指针 old
+ *   1. 记录当前下标
+ *   2. 若当前不是 TOK_END 哨兵，则游标前进一位（停在哨兵上，不会越界）
+ *   3. 返回原下标
  */
-t_lexer *consume_token(t_lexer **cur)
+int consume_token(t_cursor *cur)
 {
-    if (!cur || !*cur)
+    int old;
+
+    if (!cur || !cur->toks || cur->pos >= cur->toks->count)
+        return -1;
+    old = cur->pos;
+    if (cur->toks->type[old] != TOK_END)
+        cur->pos++;
+    return old;
+}
+
+/**
+ * token_str
+ * ----------------
+ * 目的：
+ *   取下标 idx 处 token 的文本；idx 非法时返回 NULL。
+ */
+char *token_str(t_cursor *cur, int idx)
+{
+    if (!cur || !cur->toks || idx < 0 || idx >= cur->toks->count)
         return NULL;
+    return cur->toks->str[idx];
+}
 
-    t_lexer *old = *cur;      
-    *cur = (*cur)->next;     
-    return old;               
+/**
+ * is_reserved
+ * ----------------
+ * 目的：
+ *   当前 token 是否是保留字 word：WORD 的文本与 word 相同，且源文本里
+ *   没有引号（长度不变），'time' 或 "time" 只是普通单词，与 bash 相同。
+ */
+int is_reserved(t_cursor *cur, const char *word)
+{
+    t_tokens *t;
+    int idx;
+
+    if (!cur || !cur->toks || cur->pos >= cur->toks->count)
+        return 0;
+    t = cur->toks;
+    idx = cur->pos;
+    return (t->type[idx] == TOK_WORD && t->str[idx]
+        && t->len[idx] == (int)strlen(word) && strcmp(t->str[idx], word) == 0);
+}
+
+/**
+ * token_qctx
+ * ----------------
+ * 目的：
+ *   下标 idx 处的 WORD 含 $、展开推迟到了执行时（见 expander_list），
+ *   返回它的引号注解，供 expand_cmd 使用；已是最终值时返回 NULL。
+ */
+unsigned char *token_qctx(t_cursor *cur, int idx)
+{
+    t_tokens *t;
+
+    if (!cur || !cur->toks || idx < 0 || idx >= cur->toks->count)
+        return NULL;
+    t = cur->toks;
+    if (t->type[idx] != TOK_WORD || !(t->flags[idx] & TOKF_NEEDS_EXPAND)
+        || !t->raw[idx])
+        return NULL;
+    return t->qctx + t->start[idx];
 }
 
 /**
@@ -68,27 +141,22 @@ t_lexer *consume_token(t_lexer **cur)
  * ----------------
  * 目的：
  *   检查当前 token 是否符合预期类型，如果符合则消耗它，
- *   否则打印语法错误并返回 NULL。
+ *   否则打印语法错误并返回 -1。
  *
  * 参数：
  *   - type : 期望的 token 类型
- *   - cur  : 指向当前 token 游标的指针
+ *   - cur  : token 游标
  *
  * 返回值：
- *   - 成功：返回当前 token 指针（已消耗）
- *   - 失败：当前 token 不存在或类型不匹配时返回 NULL
- *
- * 行为说明：
- *   1. 检查 cur 或 *cur 是否为 NULL，或 token 类型是否不匹配
- *   2. 如果不匹配，打印语法错误信息
- *   3. 如果匹配，调用 consume_token 消耗当前 token 并返回
+ *   - 成功：返回被消耗的 token 下标
+ *   - 失败：当前 token 类型不匹配时返回 -1
  */
-t_lexer *expect_token(tok_type type, t_lexer **cur)
+int expect_token(tok_type type, t_cursor *cur)
 {
-    if (!cur || !*cur || (*cur)->tokentype != type)
+    if (peek_token(cur) != type)
     {
         fprintf(stderr, "Syntax error : expected token type %d\n", type);
-        return NULL;
+        return -1;
     }
     return consume_token(cur);
 }
@@ -97,30 +165,39 @@ t_lexer *expect_token(tok_type type, t_lexer **cur)
  * is_redir_token
  * ----------------
  * 目的：
- *   判断给定 token 是否为重定向类型（<, >, >>, <<）。
+ *   判断给定 token 类型是否为重定向类型（<, >, >>, <<）。
  *
  * 参数：
- *   - pt : 指向当前 token
+ *   - type : token 类型
  *
  * 返回值：
  *   - 1 : token 是重定向类型
  *   - 0 : token 不是重定向类型
- *
- * 行为说明：
- *   - 检查 token 的 tokentype 是否属于以下类型：
- *       TOK_REDIR_IN, TOK_REDIR_OUT, TOK_APPEND, TOK_HEREDOC
  */
-int is_redir_token(t_lexer *pt)
+int is_redir_token(tok_type type)
 {
-    if (pt->tokentype == TOK_REDIR_IN || 
-        pt->tokentype == TOK_REDIR_OUT || 
-        pt->tokentype == TOK_APPEND || 
-        pt->tokentype == TOK_HEREDOC)
+    if (type == TOK_REDIR_IN || 
+        type == TOK_REDIR_OUT || 
+        type == TOK_APPEND || 
+        type == TOK_HEREDOC ||
+        type == TOK_HERESTRING)
         return 1;
     else
         return 0;
 }
 
+/**
+ * is_list_token
+ * ----------------
+ * 目的：
+ *   判断给定 token 类型是否为列表运算符（&&, ||, ;, &）。
+ */
+int is_list_token(tok_type type)
+{
+    return (type == TOK_AND || type == TOK_OR || type == TOK_SEMI
+        || type == TOK_AMP);
+}
+
 /**
  * safe_strdup
  * ----------------
@@ -1,18 +1,18 @@
 #include "../../include/minishell.h"
 
-void sigint_prompt(int sig)
+volatile sig_atomic_t g_signal; // 唯一全局变量
+
+// shell 自己的 SIGINT 处理函数只记下标志，不碰 readline、不打印：
+// 等待期间 SIGINT 被阻塞，由事件核心从 signalfd 读出（见 event.c）；
+// 不在等待时到达的 Ctrl+C 留在 g_signal 里，下一次等待一开始就会看到
+void sigint_flag(int sig)
 {
     g_signal = sig;
-    write(1, "\n", 1);
-    rl_on_new_line();
-    rl_replace_line("", 0);
-    rl_redisplay();
 }
 
-
 void setup_prompt_signals(void)
 {
-    signal(SIGINT, sigint_prompt);
+    signal(SIGINT, sigint_flag);
     signal(SIGQUIT, SIG_IGN);
     signal(SIGTSTP, SIG_IGN);
 }
@@ -24,18 +24,8 @@ void setup_child_signals(void)
     signal(SIGTSTP, SIG_DFL);
 }
 
-void sigint_breakline(int sig)
-{
-    (void) sig;
-    write(1, "\n", 1);
-    g_signal = 1;
-}
-
+// 执行命令期间与提示符下相同：Ctrl+C 的换行由 child_status 在前台命令结束时打印
 void setup_parent_exec_signals(void)
 {
-    signal(SIGINT, sigint_breakline);
-    signal(SIGQUIT, SIG_IGN);
-    signal(SIGTSTP, SIG_IGN);
+    setup_prompt_signals();
 }
-
-
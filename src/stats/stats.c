@@ -0,0 +1,228 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   stats.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 21:12:48 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 21:12:48 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+static const char	*g_hist_names[STH_COUNT] = {
+	"lex", "expand", "parse", "spawn",
+};
+
+static const char	*g_ctr_names[STC_COUNT] = {
+	"forks", "execs", "pipes", "heredocs", "heredoc_bytes",
+	"env_lookups", "allocs", "alloc_bytes",
+};
+
+// 统计本身（每个进程一份，fork 出来的子进程带着一份拷贝，但不输出）
+static t_stats	*stats_state(void)
+{
+	static t_stats	st;
+
+	return (&st);
+}
+
+uint64_t	stats_now(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+// 值 v 所在的桶
+static int	bucket_of(uint64_t v)
+{
+	int	shift;
+
+	if (v < ST_SUB)
+		return ((int)v);
+	shift = 63 - __builtin_clzll(v) - ST_SUB_BITS;
+	return (ST_SUB + shift * ST_SUB + (int)((v >> shift) - ST_SUB));
+}
+
+// 桶 i 的上界（落在这个桶里的最大值）
+static uint64_t	bucket_high(int i)
+{
+	int			shift;
+	uint64_t	top;
+
+	if (i < ST_SUB)
+		return ((uint64_t)i);
+	shift = (i - ST_SUB) / ST_SUB;
+	top = ST_SUB + (i - ST_SUB) % ST_SUB;
+	return (((top + 1) << shift) - 1);
+}
+
+// 记一次从 start（stats_now 的返回值）到现在的耗时
+void	stats_time(t_stat_hist h, uint64_t start)
+{
+	t_hist		*hs;
+	uint64_t	v;
+
+	v = stats_now() - start;
+	hs = &stats_state()->hist[h];
+	if (hs->count == 0 || v < hs->min)
+		hs->min = v;
+	if (v > hs->max)
+		hs->max = v;
+	hs->count++;
+	hs->sum += v;
+	hs->bucket[bucket_of(v)]++;
+}
+
+void	stats_add(t_stat_ctr c, uint64_t n)
+{
+	stats_state()->ctr[c] += n;
+}
+
+// 清零所有直方图与计数器（stats -r）
+void	stats_reset(void)
+{
+	t_stats	*st;
+
+	st = stats_state();
+	ft_bzero(st->hist, sizeof(st->hist));
+	ft_bzero(st->ctr, sizeof(st->ctr));
+}
+
+// 第 q 百分位（q 取 0 - 100）：所在桶的上界，限制在 [min, max] 之内
+static uint64_t	percentile(t_hist *hs, int q)
+{
+	uint64_t	want;
+	uint64_t	seen;
+	uint64_t	v;
+	int			i;
+
+	if (hs->count == 0)
+		return (0);
+	want = (hs->count * q + 99) / 100;
+	if (want == 0)
+		want = 1;
+	seen = 0;
+	i = 0;
+	while (i < ST_BUCKETS - 1 && seen + hs->bucket[i] < want)
+		seen += hs->bucket[i++];
+	v = bucket_high(i);
+	if (v < hs->min)
+		v = hs->min;
+	if (v > hs->max)
+		v = hs->max;
+	return (v);
+}
+
+// 把纳秒写成便于阅读的单位：812ns、3.4us、12.1ms、1.50s
+static const char	*fmt_ns(char *buf, size_t size, uint64_t ns)
+{
+	if (ns < 1000)
+		snprintf(buf, size, "%lluns", (unsigned long long)ns);
+	else if (ns < 1000000)
+		snprintf(buf, size, "%.1fus", ns / 1e3);
+	else if (ns < 1000000000)
+		snprintf(buf, size, "%.1fms", ns / 1e6);
+	else
+		snprintf(buf, size, "%.2fs", ns / 1e9);
+	return (buf);
+}
+
+static void	print_text(FILE *out, t_stats *st)
+{
+	static const int	q[] = {0, 50, 90, 99, 100};
+	char				buf[32];
+	t_hist				*hs;
+	int					i;
+	int					k;
+
+	fprintf(out, "%-10s %10s %9s %9s %9s %9s %9s %9s\n", "latency", "count",
+		"min", "p50", "p90", "p99", "max", "mean");
+	i = -1;
+	while (++i < STH_COUNT)
+	{
+		hs = &st->hist[i];
+		fprintf(out, "%-10s %10llu", g_hist_names[i],
+			(unsigned long long)hs->count);
+		k = -1;
+		while (++k < 5)
+			fprintf(out, " %9s", fmt_ns(buf, sizeof(buf),
+					q[k] == 0 ? hs->min : q[k] == 100 ? hs->max
+					: percentile(hs, q[k])));
+		fprintf(out, " %9s\n", fmt_ns(buf, sizeof(buf),
+				hs->count ? hs->sum / hs->count : 0));
+	}
+	i = -1;
+	while (++i < STC_COUNT)
+		fprintf(out, "%-14s %llu\n", g_ctr_names[i],
+			(unsigned long long)st->ctr[i]);
+}
+
+static void	print_json(FILE *out, t_stats *st)
+{
+	t_hist	*hs;
+	int		i;
+
+	fprintf(out, "{\"latency_ns\":{");
+	i = -1;
+	while (++i < STH_COUNT)
+	{
+		hs = &st->hist[i];
+		fprintf(out, "%s\"%s\":{\"count\":%llu,\"min\":%llu,\"p50\":%llu,"
+			"\"p90\":%llu,\"p99\":%llu,\"max\":%llu,\"sum\":%llu}",
+			i ? "," : "", g_hist_names[i], (unsigned long long)hs->count,
+			(unsigned long long)hs->min,
+			(unsigned long long)percentile(hs, 50),
+			(unsigned long long)percentile(hs, 90),
+			(unsigned long long)percentile(hs, 99),
+			(unsigned long long)hs->max, (unsigned long long)hs->sum);
+	}
+	fprintf(out, "},\"counters\":{");
+	i = -1;
+	while (++i < STC_COUNT)
+		fprintf(out, "%s\"%s\":%llu", i ? "," : "", g_ctr_names[i],
+			(unsigned long long)st->ctr[i]);
+	fprintf(out, "}}\n");
+}
+
+/**
+ * stats_print
+ * ----------------
+ * 目的：
+ *   输出统计：各阶段延迟的次数、最小值、p50 / p90 / p99、最大值与平均值，
+ *   以及各计数器。json 为 0 时是对齐的表格，否则是一行 JSON（纳秒）。
+ */
+void	stats_print(FILE *out, int json)
+{
+	if (json)
+		print_json(out, stats_state());
+	else
+		print_text(out, stats_state());
+	fflush(out);
+}
+
+// atexit：--stats 时在 stderr 输出统计，只由 shell 本身输出
+static void	stats_dump(void)
+{
+	t_stats	*st;
+
+	st = stats_state();
+	if (st->dump_at_exit && st->owner == getpid())
+		stats_print(stderr, st->dump_at_exit == 2);
+}
+
+// --stats（json 为 1 时 --stats=json）：登记退出时的输出
+void	stats_at_exit(int json)
+{
+	t_stats	*st;
+
+	st = stats_state();
+	if (!st->dump_at_exit)
+		atexit(stats_dump);
+	st->dump_at_exit = 1 + (json != 0);
+	st->owner = getpid();
+}
@@ -0,0 +1,86 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   stats.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 21:12:48 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 21:12:48 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/types.h>
+
+/* 直方图每个 2 的幂区间再分成 2^ST_SUB_BITS 个桶：相对误差不超过 1/16 */
+#define ST_SUB_BITS 4
+#define ST_SUB (1 << ST_SUB_BITS)
+#define ST_BUCKETS (ST_SUB + (64 - ST_SUB_BITS) * ST_SUB)
+
+/* 记延迟直方图的阶段 */
+typedef enum e_stat_hist
+{
+	STH_LEX,
+	STH_EXPAND,
+	STH_PARSE,
+	STH_SPAWN,
+	STH_COUNT,
+}	t_stat_hist;
+
+/* 计数器 */
+typedef enum e_stat_ctr
+{
+	STC_FORKS,			// 产生的子进程（fork / vfork / posix_spawn）
+	STC_EXECS,			// 成功 exec 的外部命令（exec 失败的子进程只算在 forks 里）
+	STC_PIPES,			// 打开的管道
+	STC_HEREDOCS,		// 收集的 heredoc
+	STC_HEREDOC_BYTES,	// heredoc 正文的字节数
+	STC_ENV_LOOKUPS,	// 展开 $VAR 时的变量表查找（不含 shell 自己读的变量）
+	STC_ALLOCS,			// arena 分配次数
+	STC_ALLOC_BYTES,	// arena 分配的字节数
+	STC_COUNT,
+}	t_stat_ctr;
+
+/**
+ * s_hist
+ * ----------------
+ * HDR 风格的对数-线性直方图（单位纳秒）：小于 ST_SUB 的值各占一个桶，
+ * 之后每个 2 的幂区间分 ST_SUB 个等宽的桶。记录只是一次桶下标计算加自增，
+ * 固定大小、不分配内存，适合常开。
+ */
+typedef struct s_hist
+{
+	uint64_t	count;
+	uint64_t	sum;
+	uint64_t	min;
+	uint64_t	max;
+	uint32_t	bucket[ST_BUCKETS];
+}	t_hist;
+
+/**
+ * s_stats
+ * ----------------
+ * 整个 shell 的统计：各阶段的延迟直方图与计数器。
+ * - dump_at_exit : --stats 时退出前输出（1 为文字，2 为 JSON），只由 owner 输出
+ */
+typedef struct s_stats
+{
+	t_hist		hist[STH_COUNT];
+	uint64_t	ctr[STC_COUNT];
+	int			dump_at_exit;
+	pid_t		owner;
+}	t_stats;
+
+uint64_t	stats_now(void);
+void		stats_time(t_stat_hist h, uint64_t start);
+void		stats_add(t_stat_ctr c, uint64_t n);
+void		stats_reset(void);
+void		stats_print(FILE *out, int json);
+void		stats_at_exit(int json);
+
+#endif
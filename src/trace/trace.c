@@ -0,0 +1,261 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   trace.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 20:31:05 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 20:31:05 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "../../include/minishell.h"
+
+// 跟踪状态（每个进程一份）
+static t_trace	*trace_state(void)
+{
+	static t_trace	tr;
+
+	return (&tr);
+}
+
+static uint64_t	mono_ns(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec);
+}
+
+/**
+ * trace_init
+ * ----------------
+ * 目的：
+ *   设置了 MINISHELL_TRACE 时打开跟踪：现在就打开文件（相对路径按启动时的
+ *   当前目录解析，会话中途 cd 不会让文件落到别处）并写好 JSON 开头，
+ *   登记退出时写完。没设置时什么都不做，之后的每个跟踪点只是一次判断。
+ */
+void	trace_init(void)
+{
+	t_trace		*tr;
+	const char	*path;
+	char		buf[160];
+
+	tr = trace_state();
+	path = getenv("MINISHELL_TRACE");
+	if (!path || !*path)
+		return ;
+	tr->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (tr->fd < 0)
+	{
+		perror(path);
+		return ;
+	}
+	tr->owner = getpid();
+	if (!io_write_all(tr->fd, buf, snprintf(buf, sizeof(buf),
+				"{\"traceEvents\":[\n{\"name\":\"thread_name\",\"ph\":\"M\","
+				"\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"minishell\"}}",
+				(int)tr->owner, (int)tr->owner)))
+	{
+		perror("minishell: trace");
+		close(tr->fd);
+		tr->owner = 0;
+		return ;
+	}
+	tr->t0 = mono_ns();
+	atexit(trace_flush);
+}
+
+// 当前时刻；没开跟踪时返回 0（trace_span 据此直接返回，不读时钟）
+uint64_t	trace_now(void)
+{
+	if (!trace_state()->owner)
+		return (0);
+	return (mono_ns());
+}
+
+// 写出出错时关掉跟踪，之后的跟踪点都直接返回
+static void	trace_off(t_trace *tr)
+{
+	perror("minishell: trace");
+	close(tr->fd);
+	free(tr->ring);
+	tr->ring = NULL;
+	tr->n = 0;
+	tr->owner = 0;
+}
+
+static void	put_event(t_writer *w, t_trace *tr, t_trace_ev *ev);
+
+// 把缓冲区里的事件写进文件，清空缓冲区。成功返回 1
+static int	trace_drain(t_trace *tr)
+{
+	t_writer	w;
+	size_t		i;
+
+	if (!wr_init(&w, tr->fd, 0))
+		return (0);
+	i = 0;
+	while (i < tr->n)
+		put_event(&w, tr, &tr->ring[i++]);
+	tr->n = 0;
+	i = wr_flush(&w);
+	wr_free(&w);
+	return (i);
+}
+
+// 记一个事件：第一次用时才分配缓冲区，满了先整批写出。出错返回 NULL
+static t_trace_ev	*trace_push(char ph, const char *name, pid_t tid)
+{
+	t_trace		*tr;
+	t_trace_ev	*ev;
+
+	tr = trace_state();
+	if (!tr->ring)
+		tr->ring = malloc(TRACE_RING_SIZE * sizeof(t_trace_ev));
+	if (!tr->ring || (tr->n == TRACE_RING_SIZE && !trace_drain(tr)))
+	{
+		trace_off(tr);
+		return (NULL);
+	}
+	ev = &tr->ring[tr->n++];
+	ev->ph = ph;
+	ev->name = name;
+	ev->tid = tid;
+	ev->arg_name = NULL;
+	ev->text[0] = '\0';
+	ev->dur = 0;
+	return (ev);
+}
+
+// 在 shell 的轨道上记一段：从 start（trace_now 的返回值）到现在
+void	trace_span(const char *name, uint64_t start, const char *arg_name,
+	long arg)
+{
+	t_trace_ev	*ev;
+	uint64_t	now;
+
+	if (!start || !trace_state()->owner)
+		return ;
+	now = mono_ns();
+	ev = trace_push('X', name, 0);
+	if (!ev)
+		return ;
+	ev->ts = start;
+	ev->dur = now - start;
+	ev->arg_name = arg_name;
+	ev->arg = arg;
+}
+
+// 在子进程 pid 的轨道上记一个事件：'B' 启动（name 是命令名，拷贝一份），
+// 'E' 被收割，'i' 瞬间事件（exec、exit）
+void	trace_child(char ph, const char *name, pid_t pid,
+	const char *arg_name, long arg)
+{
+	t_trace_ev	*ev;
+
+	if (!trace_state()->owner || pid <= 0)
+		return ;
+	ev = trace_push(ph, ph == 'B' ? "child" : name, pid);
+	if (!ev)
+		return ;
+	ev->ts = mono_ns();
+	ev->arg_name = arg_name;
+	ev->arg = arg;
+	if (ph == 'B' && name)
+		snprintf(ev->text, sizeof(ev->text), "%s", name);
+}
+
+// 写一个 JSON 字符串（加引号，转义引号、反斜杠与控制字符）
+static void	put_json_str(t_writer *w, const char *s)
+{
+	char	esc[8];
+
+	wr_put(w, "\"", 1);
+	while (*s)
+	{
+		if (*s == '"' || *s == '\\')
+		{
+			esc[0] = '\\';
+			esc[1] = *s;
+			wr_put(w, esc, 2);
+		}
+		else if ((unsigned char)*s < 0x20)
+			wr_put(w, esc, snprintf(esc, sizeof(esc), "\\u%04x", *s));
+		else
+			wr_put(w, s, 1);
+		s++;
+	}
+	wr_put(w, "\"", 1);
+}
+
+// 写一个事件（ts / dur 以微秒为单位，相对于 shell 启动）
+static void	put_event(t_writer *w, t_trace *tr, t_trace_ev *ev)
+{
+	char	buf[160];
+
+	wr_put(w, ",\n{\"name\":", 10);
+	if (ev->text[0])
+		put_json_str(w, ev->text);
+	else
+		put_json_str(w, ev->name);
+	wr_put(w, buf, snprintf(buf, sizeof(buf),
+			",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%d,\"tid\":%d",
+			ev->tid ? "child" : "shell", ev->ph, (ev->ts - tr->t0) / 1e3,
+			(int)tr->owner, (int)(ev->tid ? ev->tid : tr->owner)));
+	if (ev->ph == 'X')
+		wr_put(w, buf, snprintf(buf, sizeof(buf), ",\"dur\":%.3f",
+				ev->dur / 1e3));
+	if (ev->ph == 'i')
+		wr_put(w, ",\"s\":\"t\"", 8);
+	if (ev->arg_name)
+		wr_put(w, buf, snprintf(buf, sizeof(buf), ",\"args\":{\"%s\":%ld}",
+				ev->arg_name, ev->arg));
+	wr_put(w, "}", 1);
+}
+
+// fork 出来的子 shell 里调用：子进程的事件由父进程记（启动 / 收割），
+// 这里不再记，也把继承来的缓冲区还掉
+void	trace_forked(void)
+{
+	t_trace	*tr;
+
+	tr = trace_state();
+	if (!tr->owner)
+		return ;
+	free(tr->ring);
+	tr->ring = NULL;
+	tr->n = 0;
+	tr->owner = 0;
+}
+
+/**
+ * trace_flush
+ * ----------------
+ * 目的：
+ *   退出时（atexit）写完缓冲区里剩下的事件和 JSON 结尾，得到完整的
+ *   Chrome trace-event 文件 {"traceEvents":[...]}，chrome://tracing 与
+ *   ui.perfetto.dev 都能打开。shell 自己的各阶段在一条轨道上，
+ *   每个子进程一条轨道（从启动到收割）。
+ */
+void	trace_flush(void)
+{
+	t_trace		*tr;
+	const char	*end;
+
+	tr = trace_state();
+	if (!tr->owner || tr->owner != getpid())
+		return ;
+	end = "\n],\"displayTimeUnit\":\"ms\"}\n";
+	if ((tr->n && !trace_drain(tr))
+		|| !io_write_all(tr->fd, end, strlen(end)))
+	{
+		trace_off(tr);
+		return ;
+	}
+	close(tr->fd);
+	free(tr->ring);
+	tr->ring = NULL;
+	tr->owner = 0;
+}
@@ -0,0 +1,72 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   trace.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: weiyang <marvin@42.fr>                     +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 20:31:05 by weiyang           #+#    #+#             */
+/*   Updated: 2026/10/17 20:31:05 by weiyang          ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <sys/types.h>
+
+/* 缓冲区能容纳的事件数（约 320 KB），写满后整批写进文件再从头记 */
+#define TRACE_RING_SIZE 4096
+/* 事件上附带的短文本（子进程的命令名）的最大长度 */
+#define TRACE_TEXT_MAX 32
+
+/**
+ * s_trace_ev
+ * ----------------
+ * 一个跟踪事件，对应 Chrome trace-event 格式的一条记录。
+ * - ph       : 'X' 一段（ts 起，持续 dur），'B' / 'E' 子进程的开始 / 结束，'i' 瞬间
+ * - name     : 静态字符串；text 非空时以 text 为名（子进程的命令名）
+ * - tid      : 0 是 shell 自己的轨道，否则是子进程的 pid（每个子进程一条轨道）
+ * - arg_name : 附带的一个整数参数的名字（pid、退出状态、字节数），NULL 表示没有
+ */
+typedef struct s_trace_ev
+{
+	const char	*name;
+	const char	*arg_name;
+	uint64_t	ts;
+	uint64_t	dur;
+	long		arg;
+	pid_t		tid;
+	char		ph;
+	char		text[TRACE_TEXT_MAX];
+}	t_trace_ev;
+
+/**
+ * s_trace
+ * ----------------
+ * 设置了 MINISHELL_TRACE=文件 时的跟踪状态：事件先记在 ring 里（n 是其中的条数），
+ * 记满时整批写进文件，退出时写完剩下的，得到 Chrome / Perfetto 能直接打开的 JSON。
+ * ring 在第一个事件时才分配。时间取 CLOCK_MONOTONIC，t0 是 shell 启动的时刻。
+ * - owner : 开着跟踪的进程（0 表示没开）；fork 出来的子 shell 调 trace_forked 关掉
+ * - fd    : 跟踪文件，启动时就打开（相对路径按启动时的目录解析，之后 cd 不影响）
+ */
+typedef struct s_trace
+{
+	t_trace_ev	*ring;
+	size_t		n;
+	uint64_t	t0;
+	pid_t		owner;
+	int			fd;
+}	t_trace;
+
+void		trace_init(void);
+uint64_t	trace_now(void);
+void		trace_span(const char *name, uint64_t start, const char *arg_name,
+				long arg);
+void		trace_child(char ph, const char *name, pid_t pid,
+				const char *arg_name, long arg);
+void		trace_forked(void);
+void		trace_flush(void);
+
+#endif
@@ -0,0 +1,52 @@
+#!/bin/sh
+# 回归测试：批处理模式下，shell 启动的命令读 shell 自己的标准输入。
+# shell 只能读走当前这一行，后面的行属于命令（与 bash 相同）。
+# 用法：sh tests/stdin_child.sh [minishell 路径]
+
+MS=${1:-./minishell}
+TMP=${TMPDIR:-/tmp}/msh_stdin.$$
+fail=0
+
+# check 名称 期望输出 输入：输入经管道交给 shell
+check()
+{
+	out=$(printf "$3" | "$MS" 2>&1)
+	compare "$1" "$2" "$out"
+}
+
+# check_file 名称 期望输出 输入：输入写进文件，重定向为 shell 的标准输入
+# （可 seek，shell 会预读后面的行）
+check_file()
+{
+	printf "$3" > "$TMP"
+	out=$("$MS" < "$TMP" 2>&1)
+	compare "$1" "$2" "$out"
+}
+
+compare()
+{
+	if [ "$3" != "$2" ]; then
+		printf 'FAIL %s\n  expected: %s\n  got:      %s\n' "$1" "$2" "$3"
+		fail=1
+	fi
+}
+
+check "pipe: head -1" "foo" 'head -1\nfoo\necho bar\n'
+check "pipe: cat" "$(printf 'l2\nl3')" 'cat\nl2\nl3\n'
+check "pipe: heredoc then cat" "$(printf 'h\nrest')" 'cat <<E\nh\nE\ncat\nrest\n'
+check "pipe: lookahead then cat" "$(printf 'a\nl2')" \
+	'sleep 0.1 < /dev/null\necho a\ncat\nl2\n'
+check "pipe: lookahead stops at a reader" "$(printf 'a\nl2\nb')" \
+	'sleep 0.1 < /dev/null\necho a\nhead -c 3\nl2\necho b\n'
+check_file "file: cat" "$(printf 'l2\nl3')" 'cat\nl2\nl3\n'
+check_file "file: head -c" "$(printf 'abc\nx')" 'head -c 4\nabc\necho x\n'
+check_file "file: lookahead then cat" "$(printf 'a\nl2')" \
+	'sleep 0.1\necho a\ncat\nl2\n'
+check_file "file: read then run" "$(printf 'abc\nx')" \
+	'sleep 0.1\nhead -c 4\nabc\necho x\n'
+
+rm -f "$TMP"
+if [ $fail -eq 0 ]; then
+	echo "stdin_child: ok"
+fi
+exit $fail